@@ -0,0 +1,135 @@
+#!/bin/sh
+#
+# Compile-time benchmark: generates translation units with a growing number of bindings and
+# overloads, and reports the compilation time and object size for each of them.
+#
+# usage: bench/compile_time.sh [header|extern|lean|module]...
+#
+# environment:
+#   CXX        compiler (default c++)
+#   CXXFLAGS   extra flags (default -O2)
+#   BINDINGS   numbers of add_function calls (default "1 10 50 100 200")
+#   OVERLOADS  numbers of functions per call (default "1 4")
+#
+# output (csv): mode,bindings,overloads,seconds,object bytes,text bytes
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:--O2}
+BINDINGS=${BINDINGS:-1 10 50 100 200}
+OVERLOADS=${OVERLOADS:-1 4}
+MODES=${*:-header extern lean module}
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+FLAGS="-std=c++23 $CXXFLAGS -I$ROOT/include"
+
+if $CXX --version | grep -q clang
+then
+    MODULE_BUILD="--precompile -x c++-module $ROOT/src/xtcl.cppm -o $WORK/xtcl.pcm"
+    MODULE_FLAGS="-fmodule-file=xtcl=$WORK/xtcl.pcm"
+else
+    MODULE_BUILD="-fmodules-ts -c -x c++ $ROOT/src/xtcl.cppm -o $WORK/xtcl_module.o"
+    MODULE_FLAGS="-fmodules-ts"
+fi
+
+# signatures cycled through by the generated overloads
+SIGNATURES='(int a) {return a;}
+(double a, double b) {return a * b;}
+(std::string const & s) {return s.size();}
+(std::vector<double> const & v) {return v;}
+(std::map<std::string, int> const & m) {return m.size();}
+(int a, std::string s) {return s + std::to_string(a);}
+(std::vector<std::string> v, bool b) {return b ? v.size() : 0;}
+(std::set<int> const & s, float f) {return f * s.size();}'
+
+generate()
+{
+    mode=$1 bindings=$2 overloads=$3
+
+    if [ "$mode" = module ]
+    then
+        echo '#include <tcl/tcl.h>'
+        echo '#include <string>'
+        echo '#include <vector>'
+        echo '#include <map>'
+        echo '#include <set>'
+        echo 'import xtcl;'
+    else
+        echo '#include <xtcl.h>'
+    fi
+
+    echo 'void bind(Tcl_Interp * tcl)'
+    echo '{'
+
+    b=0
+    while [ $b -lt "$bindings" ]
+    do
+        printf '    Xtcl::add_function(tcl, "cmd%d"' $b
+        o=0
+        while [ $o -lt "$overloads" ]
+        do
+            # a distinct lambda per overload, as in real bindings
+            printf ',\n        [] %s' "$(echo "$SIGNATURES" | sed -n "$(( (b + o) % 8 + 1 ))p")"
+            o=$((o + 1))
+        done
+        printf ');\n'
+        b=$((b + 1))
+    done
+
+    echo '}'
+}
+
+now()
+{
+    date +%s.%N
+}
+
+echo "mode,bindings,overloads,seconds,object bytes,text bytes"
+
+for mode in $MODES
+do
+    case $mode in
+        header) flags="$FLAGS" ;;
+        extern)
+            flags="$FLAGS -DXTCL_EXTERN_TEMPLATES=1"
+            (cd "$WORK" && $CXX $flags -c "$ROOT/src/xtcl_instances.cpp" -o "$WORK/xtcl_instances.o")
+            ;;
+        lean) flags="$FLAGS -DXTCL_LEAN_DISPATCH=1" ;;
+        module)
+            flags="$FLAGS $MODULE_FLAGS"
+            (cd "$WORK" && $CXX $FLAGS $MODULE_BUILD)
+            ;;
+        *) echo "unknown mode $mode" >&2; exit 1 ;;
+    esac
+
+    for bindings in $BINDINGS
+    do
+        for overloads in $OVERLOADS
+        do
+            src=$WORK/bind_${mode}_${bindings}_${overloads}.cpp
+            obj=${src%.cpp}.o
+
+            generate "$mode" "$bindings" "$overloads" > "$src"
+
+            start=$(now)
+            (cd "$WORK" && $CXX $flags -c "$src" -o "$obj")
+            stop=$(now)
+
+            # bindings are linked with the instances, as a program would be (duplicate definitions in headers)
+            if [ "$mode" = extern ]
+            then
+                $CXX -r -nostdlib "$obj" "$WORK/xtcl_instances.o" -o "${obj%.o}_linked.o"
+            fi
+
+            seconds=$(echo "$start $stop" | awk '{printf "%.2f", $2 - $1}')
+            bytes=$(wc -c < "$obj")
+            text=$(size "$obj" | awk 'NR == 2 {print $1}')
+
+            echo "$mode,$bindings,$overloads,$seconds,$bytes,$text"
+        done
+    done
+done
@@ -10,6 +10,8 @@
 #include <expected>
 #include <string>
 #include <tuple>
+#include <array>
+#include <span>
 
 // error handling
 #include <sstream>
@@ -17,6 +19,12 @@
 #include "xtcl_def.h"
 #include "xtcl_type.h"
 #include "xtcl_error.h"
+#include "xtcl_var.h"
+#include "xtcl_cancel.h"
+
+#if XTCL_TRACE
+#include "xtcl_trace.h"
+#endif
 
 using namespace std::literals;
 using namespace std::string_literals;
@@ -27,37 +35,169 @@ namespace Xtcl
     {
         using TclResult = Result<int>;
 
-        using Function = std::function<TclResult(Tcl_Interp *, int, Tcl_Obj * const [])>;
+        // overload, along with its position in the binding, which may differ from the order it is tried in
+        struct Function
+        {
+            std::function<TclResult(Tcl_Interp *, int, Tcl_Obj * const [])> call;
+            std::size_t index;
+        };
 
         template <std::size_t S>
         struct CmdData
         {
             std::array<Function, S> fns;
+#if XTCL_TRACE
+            Trace::Name trace;
+#endif
+        };
+
+        XTCL_OUTLINE inline TclResult set_result(Tcl_Interp * tcl, ToResult && r)
+        {
+            if (not r)
+            {
+                return Error::forward(r.error());
+            }
+
+            Tcl_SetObjResult(tcl, *r);
+
+            return TCL_OK;
+        }
+
+        XTCL_OUTLINE inline TclResult args_error(Tcl_Obj * cmd, void (* signature)(std::ostream &), Error && error)
+        {
+            return Error::generic
+            (
+                [error = std::move(error), name = std::string(Tcl_GetString(cmd)), signature] (std::ostream &os)
+                {
+                    os << name;
+                    signature(os);
+                    os << ": "sv << error;
+                }
+            );
+        }
+
+        // errors of the overloads tried, in the order they were given
+        XTCL_OUTLINE inline int set_errors(Tcl_Interp * tcl, std::span<Function const> tried, std::span<Error const> errors)
+        {
+            std::ostringstream os {};
+            bool first {true};
+            for (auto [i, e] : std::views::enumerate(errors))
+            {
+                if (std::ranges::find(tried, std::size_t(i), &Function::index) == tried.end())
+                {
+                    continue;
+                }
+                if (not std::exchange(first, false)) os << std::endl;
+                os << e;
+            }
+
+            Tcl_SetObjResult(tcl, Tcl_NewStringObj(os.str().c_str(), -1));
+
+            return TCL_ERROR;
+        }
+
+        XTCL_OUTLINE inline int call_functions(Tcl_Interp * tcl, std::span<Function const> fns, std::span<Error> errors, int objc, Tcl_Obj * const objv[])
+        {
+            // the interpreter hands over an empty result, only a failed attempt may have altered it
+            Tcl_Obj * result = Tcl_GetObjResult(tcl);
+
+            for (auto const & [i, f] : std::views::enumerate(fns))
+            {
+                // a value assigned in place leaves no string representation, and a stale length
+                if ((i != 0) and ((Tcl_GetObjResult(tcl) != result) or (result->bytes == nullptr) or (result->length != 0) or (result->typePtr != nullptr)))
+                {
+                    Tcl_ResetResult(tcl);
+                    result = Tcl_GetObjResult(tcl);
+                }
+
+#if XTCL_TRACE
+                Trace::mark(&Trace::Span::attempt);
+#endif
+
+                interrupted() = false;
+
+                auto r = f.call(tcl, objc - 1, objv + 1);
+                if (r)
+                {
+#if XTCL_TRACE
+                    Trace::overload(f.index);
+#endif
+                    return *r;
+                }
+                else
+                {
+                    errors[f.index] = std::move(r.error());
+
+                    // the other overloads would be interrupted as well
+                    if (Xtcl::canceled(tcl))
+                    {
+                        return set_errors(tcl, fns.first(i + 1), errors);
+                    }
+                }
+            }
+
+            return set_errors(tcl, fns, errors);
+        }
+
+        // arguments decoded from the command words, injected ones being left out
+        template <typename D, typename ...As>
+        struct Decoded
+        {
+            using Tuple = D;
         };
 
+        template <typename ...Ds, typename A, typename ...As>
+        struct Decoded<Tuple<Ds...>, A, As...> : public Decoded<std::conditional_t<Injected<A>, Tuple<Ds...>, Tuple<Ds..., A>>, As...> {};
+
+        template <typename R>
+        struct Fallible : public std::false_type {};
+
+        template <typename T>
+        struct Fallible<Result<T>> : public std::true_type {};
+
         template <typename R, typename ...As>
         struct FunctionHelper
         {
+            // returned values are forwarded, so that temporaries are moved into their Tcl representation
             template <typename T>
             struct Return
             {
-                static ToResult to(Tcl_Interp * tcl, T const & value)
+                static TclResult set(Tcl_Interp * tcl, T && value)
                 {
-                    return Xtcl::to(tcl, value);
+                    if constexpr (Assignable<T>)
+                    {
+                        // recycle the interpreter's result object instead of allocating a new one
+                        Tcl_Obj * obj = Tcl_GetObjResult(tcl);
+
+                        if (not Tcl_IsShared(obj))
+                        {
+                            Type<Value<T>>::assign(obj, value);
+                            return TCL_OK;
+                        }
+                    }
+
+                    return set_result(tcl, Xtcl::to(tcl, std::forward<T>(value)));
                 }
             };
 
             template <typename T>
             struct Return<Result<T>>
             {
-                static ToResult to(Tcl_Interp * tcl, Result<T> && value)
+                static TclResult set(Tcl_Interp * tcl, Result<T> && value)
                 {
                     if (not value)
                     {
                         return Error::forward(value.error());
                     }
 
-                    return Xtcl::to(tcl, *value);
+                    if constexpr (std::is_void_v<T>)
+                    {
+                        return TCL_OK;
+                    }
+                    else
+                    {
+                        return Return<T>::set(tcl, *std::move(value));
+                    }
                 }
             };
 
@@ -65,9 +205,9 @@ namespace Xtcl
             template <typename T>
             struct Return<T *>
             {
-                static ToResult to(Tcl_Interp * tcl, T * const value)
+                static TclResult set(Tcl_Interp * tcl, T * const value)
                 {
-                    return Xtcl::to(tcl, *value);
+                    return Return<T &>::set(tcl, *value);
                 }
             };
 #endif
@@ -76,9 +216,9 @@ namespace Xtcl
             template <>
             struct Return<char const *>
             {
-                static ToResult to(Tcl_Interp * tcl, char const * value)
+                static TclResult set(Tcl_Interp * tcl, char const * value)
                 {
-                    return Xtcl::to(tcl, value);
+                    return set_result(tcl, Xtcl::to(tcl, value));
                 }
             };
 #endif
@@ -119,54 +259,144 @@ namespace Xtcl
 
             static constexpr std::size_t const S {sizeof ...(As)};
 
+            static constexpr bool const commits {(Committed<Value<As>> or ...)};
+
+            static_assert(((not Committed<Value<As>> or std::is_lvalue_reference_v<As>) and ...), "arguments written back (Xtcl::Var, Xtcl::OutChannel) must be taken by reference");
+
+            // Var arguments are written back once the function has returned
+            template <typename Vs>
+            static Result<void> commit(Vs & args)
+            {
+                if constexpr (commits)
+                {
+                    return std::apply
+                    (
+                        [] (auto & ...as)
+                        {
+                            Result<void> r {};
+                            ((r = detail::commit(as)) and ...);
+                            return r;
+                        },
+                        args
+                    );
+                }
+                else
+                {
+                    return {};
+                }
+            }
+
+            using T = typename Decoded<Tuple<>, As...>::Tuple;
+
+            static constexpr bool const injects {(Injected<As> or ...)};
+
+            // index of each argument among the decoded ones
+            static constexpr std::array<std::size_t, S> const positions {[]
+            {
+                std::array<std::size_t, S> positions {};
+                std::size_t i {}, n {};
+                ((positions[i++] = n, n += Injected<As> ? 0 : 1), ...);
+                return positions;
+            }()};
+
+            template <std::size_t I, typename Ds>
+            static auto supply(Tcl_Interp * tcl, Ds & decoded)
+            {
+                using A = std::tuple_element_t<I, std::tuple<As...>>;
+
+                if constexpr (Injected<A>)
+                {
+                    return Type<Value<A>>::inject(tcl);
+                }
+                else
+                {
+                    return std::move(std::get<positions[I]>(decoded));
+                }
+            }
+
+            // all the arguments, the decoded ones as they are when none is injected
+            template <typename Ds>
+            static decltype(auto) supply(Tcl_Interp * tcl, Ds & decoded)
+            {
+                if constexpr (injects)
+                {
+                    return [tcl, &decoded] <std::size_t ...Is> (std::index_sequence<Is...>)
+                    {
+                        return std::tuple<Value<As>...> {supply<Is>(tcl, decoded)...};
+                    }
+                    (std::index_sequence_for<As...> {});
+                }
+                else
+                {
+                    return (decoded);
+                }
+            }
+
+            static void signature(std::ostream & os)
+            {
+                if constexpr (std::tuple_size_v<typename T::Values> != 0)
+                {
+                    os << ' ' << T {};
+                }
+            }
+
             template <std::size_t ...Is>
             static Function make(std::function<R (As...)> && fn, std::index_sequence<Is...>)
             {
-                // using F = std::function<R (As...)>;
-                using T = detail::Tuple<As...>;
-
                 return Function
                 {
-                    [fn = std::move(fn)] (Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[]) -> TclResult
+                    .call = [fn = std::move(fn)] (Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[]) -> TclResult
                     {
-                        Tcl_ResetResult(tcl);
-
-                        auto args = T::from(tcl, objc, objv);
+                        auto decoded = T::from(tcl, objc, objv);
 
-                        if (not args)
+                        if (not decoded)
                         {
-                            return Error::generic
-                            (
-                                [error = std::move(args.error()), name = std::string(Tcl_GetString(objv[-1]))](std::ostream &os)
-                                {
-                                    os << name;
-                                    if constexpr (S != 0)
-                                    {
-                                        os << ' ' << T {};
-                                    }
-                                    os << ": "sv << error;
-                                }
-                            );
+                            return args_error(objv[-1], signature, std::move(decoded.error()));
                         }
 
+                        auto && args = supply(tcl, *decoded);
+
+#if XTCL_TRACE
+                        Trace::mark(&Trace::Span::decoded);
+#endif
+
                         if constexpr (std::is_void_v<R>)
                         {
-                            fn(Arg<As>::forward(std::get<Is>(*args))...);
+                            fn(Arg<As>::forward(std::get<Is>(args))...);
+#if XTCL_TRACE
+                            Trace::mark(&Trace::Span::called);
+#endif
+                            if (auto c = commit(args); not c)
+                            {
+                                return Error::forward(c.error());
+                            }
                         }
                         else
                         {
-                            auto r = Return<R>::to(tcl, fn(Arg<As>::forward(std::get<Is>(*args))...));
-
-                            if (not r)
+                            auto && r = fn(Arg<As>::forward(std::get<Is>(args))...);
+#if XTCL_TRACE
+                            Trace::mark(&Trace::Span::called);
+#endif
+                            // variables are only written back when the function succeeds
+                            if constexpr (Fallible<std::remove_cvref_t<R>>::value)
                             {
-                                return Error::forward(r.error());
+                                if (not r)
+                                {
+                                    return Error::forward(r.error());
+                                }
                             }
 
-                            Tcl_SetObjResult(tcl, *r);
+                            if (auto c = commit(args); not c)
+                            {
+                                return Error::forward(c.error());
+                            }
+                            return Return<R>::set(tcl, std::forward<R>(r));
                         }
 
                         return TCL_OK;
-                    }
+                    },
+                    // set by make_functions
+                    .index = 0
                 };
             }
 
@@ -182,6 +412,38 @@ namespace Xtcl
             return FunctionHelper<R, As...>::make(std::move(f));
         }
 
+        template <typename F>
+        struct Variadic;
+
+        template <typename R, typename ...As>
+        struct Variadic<std::function<R(As...)>> : public std::bool_constant<FunctionHelper<R, As...>::T::trailing> {};
+
+        // overloads taking trailing arguments (see Xtcl::Rest) are tried after the fixed arity ones
+        template <typename ...Fs>
+        std::array<Function, sizeof ...(Fs)> make_functions(Fs && ...fs)
+        {
+            constexpr std::size_t const S {sizeof ...(Fs)};
+
+            static constexpr std::array<bool, S> const variadic {Variadic<decltype(std::function{std::declval<Fs>()})>::value...};
+
+            static constexpr std::array<std::size_t, S> const order {[]
+            {
+                std::array<std::size_t, S> order {};
+                std::size_t n {};
+                for (std::size_t i = 0; i < S; ++i) if (not variadic[i]) order[n++] = i;
+                for (std::size_t i = 0; i < S; ++i) if (variadic[i]) order[n++] = i;
+                return order;
+            }()};
+
+            std::array<Function, S> fns {make_function(std::function{std::forward<Fs>(fs)})...};
+
+            return [&fns] <std::size_t ...Is> (std::index_sequence<Is...>)
+            {
+                return std::array<Function, S> {Function {std::move(fns[order[Is]].call), order[Is]}...};
+            }
+            (std::make_index_sequence<S> {});
+        }
+
         template <std::size_t S>
         void delete_function(ClientData cdata)
         {
@@ -195,34 +457,13 @@ namespace Xtcl
             {
                 auto & data = *static_cast<CmdData<S> *>(cdata);
 
-                std::array<Error, S> errors{};
-
-                for (auto const & [i, f] : std::views::enumerate(data.fns))
-                {
-                    auto r = f(tcl, objc - 1, objv + 1);
-                    if (r)
-                    {
-                        return *r;
-                    }
-                    else
-                    {
-                        errors[i] = std::move(r.error());
-                    }
-                }
-
-                std::ostringstream os {};
-                for (auto [i, e] : std::views::enumerate(errors))
-                {
-                    if constexpr (S > 1)
-                    {
-                        if (i != 0) os << std::endl;
-                    }
-                    os << e;
-                }
+#if XTCL_TRACE
+                Trace::Scope trace {data.trace};
+#endif
 
-                Tcl_SetObjResult(tcl, Tcl_NewStringObj(os.str().c_str(), -1));
+                std::array<Error, S> errors {};
 
-                return TCL_ERROR;
+                return call_functions(tcl, data.fns, errors, objc, objv);
             }
             else
             {
@@ -237,7 +478,10 @@ namespace Xtcl
 
             auto * data = new CmdData<S>
             {
-                .fns = {make_function(std::function{std::forward<Fs>(fs)})...}
+                .fns = make_functions(std::forward<Fs>(fs)...),
+#if XTCL_TRACE
+                .trace = Trace::name(name)
+#endif
             };
 
             Tcl_CreateObjCommand(tcl, name, call_function<S>, data, delete_function<S>);
@@ -0,0 +1,322 @@
+#ifndef XTCL_ABSTRACT_H
+#define XTCL_ABSTRACT_H
+
+#include <tcl/tcl.h>
+
+#include <utility>
+#include <ranges>
+#include <string_view>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "xtcl_def.h"
+#include "xtcl_type.h"
+#include "xtcl_error.h"
+
+using namespace std::literals;
+
+namespace Xtcl
+{
+    namespace detail
+    {
+        template <typename R>
+        struct RefView : public std::false_type {};
+
+        template <typename R>
+        struct RefView<std::ranges::ref_view<R>> : public std::true_type {};
+
+        // whether the view refers to a range it does not own, directly or through the views it adapts
+        template <typename R>
+        consteval bool referring()
+        {
+            if constexpr (RefView<R>::value)
+            {
+                return true;
+            }
+            else if constexpr (requires (R const & range) {{range.base()} -> std::ranges::view;})
+            {
+                return referring<std::remove_cvref_t<decltype (std::declval<R const &>().base())>>();
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        // element types of which the encoding cannot fail, and can thus be deferred to the first access
+        template <typename T>
+        concept Infallible = std::is_arithmetic_v<T> or std::same_as<T, std::string> or std::same_as<T, std::string_view> or std::same_as<T, Literal>;
+    }
+
+    // returned container or random access range, kept as the storage of the list rather than encoded into it (Tcl 9)
+    template <std::ranges::random_access_range R>
+    requires std::ranges::sized_range<R>
+    class AbstractList
+    {
+        static_assert(not detail::referring<R>(), "an abstract list outlives the function: its range must own its elements, not view an lvalue");
+
+        R elements;
+
+    public :
+
+        explicit AbstractList(R && range) : elements {std::move(range)} {}
+        explicit AbstractList(R const & range) : elements {range} {}
+
+        R & operator * () {return elements;}
+        R const & operator * () const {return elements;}
+
+        R * operator -> () {return &elements;}
+        R const * operator -> () const {return &elements;}
+    };
+
+    template <typename R>
+    AbstractList(R &&) -> AbstractList<std::remove_cvref_t<R>>;
+
+#if TCL_MAJOR_VERSION >= 9
+    namespace detail
+    {
+        // storage of an abstract list, shared by its duplicates, its elements being encoded on first access and kept
+        class AbstractStore
+        {
+            std::size_t refs;
+            std::size_t count;
+            std::vector<Tcl_Obj *> objs;
+
+        protected :
+
+            virtual Tcl_Obj * encode(std::size_t i) = 0;
+
+        public :
+
+            AbstractStore(std::size_t count) : refs {1}, count {count}, objs {} {}
+
+            AbstractStore(AbstractStore const &) = delete;
+            AbstractStore & operator = (AbstractStore const &) = delete;
+
+            virtual ~AbstractStore()
+            {
+                for (Tcl_Obj * obj : objs)
+                {
+                    if (obj != nullptr)
+                    {
+                        Tcl_DecrRefCount(obj);
+                    }
+                }
+            }
+
+            std::size_t size() const
+            {
+                return count;
+            }
+
+            void retain()
+            {
+                ++refs;
+            }
+
+            void release()
+            {
+                if (--refs == 0)
+                {
+                    delete this;
+                }
+            }
+
+            // owned by the store, as the elements of a list are owned by the list
+            XTCL_OUTLINE Tcl_Obj * element(std::size_t i)
+            {
+                if (objs.empty())
+                {
+                    objs.resize(size());
+                }
+
+                if (objs[i] == nullptr)
+                {
+                    objs[i] = encode(i);
+                    Tcl_IncrRefCount(objs[i]);
+                }
+
+                return objs[i];
+            }
+
+            XTCL_OUTLINE Tcl_Obj ** elements()
+            {
+                for (std::size_t i = 0; i < size(); ++i)
+                {
+                    element(i);
+                }
+
+                return objs.data();
+            }
+        };
+
+        template <typename R>
+        class AbstractRange : public AbstractStore
+        {
+            using T = Value<std::ranges::range_reference_t<R>>;
+
+            static_assert(Infallible<T>, "only elements that are always encoded can be encoded on access");
+
+            R range;
+
+        protected :
+
+            Tcl_Obj * encode(std::size_t i) override
+            {
+                return *Xtcl::to(nullptr, std::ranges::begin(range)[i]);
+            }
+
+        public :
+
+            AbstractRange(R && range) : AbstractStore {std::size_t(std::ranges::size(range))}, range {std::move(range)} {}
+        };
+
+        inline AbstractStore * abstract_store(Tcl_Obj * obj)
+        {
+            return static_cast<AbstractStore *>(obj->internalRep.twoPtrValue.ptr1);
+        }
+
+        inline void abstract_free(Tcl_Obj * obj)
+        {
+            abstract_store(obj)->release();
+        }
+
+        inline void abstract_dup(Tcl_Obj * src, Tcl_Obj * dup)
+        {
+            abstract_store(src)->retain();
+            dup->internalRep.twoPtrValue.ptr1 = src->internalRep.twoPtrValue.ptr1;
+            dup->internalRep.twoPtrValue.ptr2 = nullptr;
+            dup->typePtr = src->typePtr;
+        }
+
+        // the string of a list of all the elements, which are encoded for good
+        inline void abstract_update(Tcl_Obj * obj)
+        {
+            auto & store = *abstract_store(obj);
+
+            Tcl_Obj * list = Tcl_NewListObj(Tcl_Size(store.size()), store.elements());
+            Tcl_Size length;
+            char const * bytes = Tcl_GetStringFromObj(list, &length);
+
+            obj->bytes = Tcl_Alloc(length + 1);
+            std::memcpy(obj->bytes, bytes, std::size_t(length) + 1);
+            obj->length = length;
+
+            Tcl_DecrRefCount(list);
+        }
+
+        inline Tcl_Size abstract_length(Tcl_Obj * obj)
+        {
+            return Tcl_Size(abstract_store(obj)->size());
+        }
+
+        inline int abstract_index(Tcl_Interp *, Tcl_Obj * obj, Tcl_Size index, Tcl_Obj ** element)
+        {
+            auto & store = *abstract_store(obj);
+
+            *element = ((index < 0) or (std::size_t(index) >= store.size())) ? nullptr : store.element(std::size_t(index));
+
+            return TCL_OK;
+        }
+
+        // called when the list shimmers to a plain list
+        inline int abstract_elements(Tcl_Interp *, Tcl_Obj * obj, Tcl_Size * objc, Tcl_Obj *** objv)
+        {
+            auto & store = *abstract_store(obj);
+
+            *objv = store.elements();
+            *objc = Tcl_Size(store.size());
+
+            return TCL_OK;
+        }
+
+        inline Tcl_ObjType const * abstract_type()
+        {
+            static Tcl_ObjType const type
+            {
+                "xtcl::list", abstract_free, abstract_dup, abstract_update, nullptr,
+                TCL_OBJTYPE_V2(abstract_length, abstract_index, nullptr, nullptr, abstract_elements, nullptr, nullptr, nullptr)
+            };
+            return &type;
+        }
+
+        template <typename R>
+        Tcl_Obj * abstract_list(R range)
+        {
+            Tcl_Obj * obj = Tcl_NewObj();
+            Tcl_InvalidateStringRep(obj);
+
+            obj->internalRep.twoPtrValue.ptr1 = static_cast<AbstractStore *>(new AbstractRange<R> {std::move(range)});
+            obj->internalRep.twoPtrValue.ptr2 = nullptr;
+            obj->typePtr = abstract_type();
+
+            return obj;
+        }
+    }
+#endif
+
+    template <typename R>
+    class Type<AbstractList<R>>
+    {
+        using T = Value<std::ranges::range_reference_t<R>>;
+
+        static auto make_name()
+        {
+            return std::format("<list {}>"sv, Type<T>::name());
+        }
+
+        // Tcl 8.6 has no abstract lists, the elements are encoded up front
+        template <typename V>
+        static ToResult to_list(Tcl_Interp * tcl, V && range)
+        {
+            Tcl_Obj * list = Tcl_NewListObj(0, nullptr);
+
+            for (auto && e : range)
+            {
+                auto obj = Xtcl::to(tcl, std::forward_like<V>(e));
+                if (not obj)
+                {
+                    Tcl_DecrRefCount(list);
+                    return Error::forward(obj.error());
+                }
+                Tcl_ListObjAppendElement(tcl, list, *obj);
+            }
+
+            return list;
+        }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        // elements of which the encoding can fail are encoded up front too, for the error to be returned
+        static ToResult to(Tcl_Interp * tcl, AbstractList<R> const & list)
+        {
+#if TCL_MAJOR_VERSION >= 9
+            if constexpr (detail::Infallible<T>)
+            {
+                return detail::abstract_list(R {*list});
+            }
+#endif
+            return to_list(tcl, *list);
+        }
+
+        static ToResult to(Tcl_Interp * tcl, AbstractList<R> && list)
+        {
+#if TCL_MAJOR_VERSION >= 9
+            if constexpr (detail::Infallible<T>)
+            {
+                return detail::abstract_list(std::move(*list));
+            }
+#endif
+            return to_list(tcl, std::move(*list));
+        }
+    };
+}
+
+#endif
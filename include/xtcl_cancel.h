@@ -0,0 +1,124 @@
+#ifndef XTCL_CANCEL_H
+#define XTCL_CANCEL_H
+
+#include <tcl/tcl.h>
+
+#include <cstdint>
+#include <string_view>
+
+#include "xtcl_def.h"
+#include "xtcl_type.h"
+#include "xtcl_error.h"
+
+using namespace std::literals;
+
+namespace Xtcl
+{
+    namespace detail
+    {
+        // set when an Xtcl::Cancel stops a function, cleared by the binding before each attempt: Tcl_Canceled cannot
+        // be asked again, as it clears the cancellation it reports
+        inline bool & interrupted()
+        {
+            thread_local bool interrupted {};
+            return interrupted;
+        }
+    }
+
+    // whether the last function called was stopped by its Xtcl::Cancel, or the interpreter went over a limit
+    inline bool canceled(Tcl_Interp * tcl)
+    {
+        return detail::interrupted() or (Tcl_LimitExceeded(tcl) != 0);
+    }
+
+    // argument supplied by the binding, to be checked by functions running for long
+    class Cancel
+    {
+        Tcl_Interp * tcl;
+        std::uint32_t stride;
+        std::uint32_t count;
+
+        static Result<void> error(Tcl_Interp * tcl)
+        {
+            detail::interrupted() = true;
+            return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+        }
+
+        // the interpreter only checks its time limit every few commands, its granularity is lowered to check it now
+        static int check_time(Tcl_Interp * tcl)
+        {
+            Tcl_Time limit, now;
+            Tcl_LimitGetTime(tcl, &limit);
+            Tcl_GetTime(&now);
+
+            if ((now.sec < limit.sec) or ((now.sec == limit.sec) and (now.usec < limit.usec)))
+            {
+                return TCL_OK;
+            }
+
+            int const granularity {Tcl_LimitGetGranularity(tcl, TCL_LIMIT_TIME)};
+            Tcl_LimitSetGranularity(tcl, TCL_LIMIT_TIME, 1);
+            int const code {Tcl_LimitCheck(tcl)};
+            Tcl_LimitSetGranularity(tcl, TCL_LIMIT_TIME, granularity);
+
+            return code;
+        }
+
+    public :
+
+        explicit Cancel(Tcl_Interp * tcl, std::uint32_t stride = XTCL_CANCEL_STRIDE) : tcl {tcl}, stride {stride}, count {} {}
+
+        // polls the interpreter every stride calls
+        Result<void> operator () ()
+        {
+            if (++count < stride)
+            {
+                return {};
+            }
+
+            count = 0;
+
+            return poll();
+        }
+
+        // runs the pending asynchronous handlers (Tcl_AsyncMark), and fails when the evaluation must stop
+        XTCL_OUTLINE Result<void> poll()
+        {
+            if (Tcl_AsyncReady() and (Tcl_AsyncInvoke(tcl, TCL_OK) != TCL_OK))
+            {
+                return error(tcl);
+            }
+
+            if (Tcl_Canceled(tcl, TCL_LEAVE_ERR_MSG) == TCL_ERROR)
+            {
+                return error(tcl);
+            }
+
+            if (Tcl_LimitTypeEnabled(tcl, TCL_LIMIT_TIME) and (check_time(tcl) != TCL_OK))
+            {
+                return error(tcl);
+            }
+
+            if (Tcl_LimitExceeded(tcl))
+            {
+                detail::interrupted() = true;
+                return Error::text("limit exceeded"s);
+            }
+
+            return {};
+        }
+    };
+
+    template <>
+    struct Type<Cancel>
+    {
+        static auto name() {return "<cancel>"sv;}
+
+        static Cancel inject(Tcl_Interp * tcl)
+        {
+            return Cancel {tcl};
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,337 @@
+#ifndef XTCL_CHANNEL_H
+#define XTCL_CHANNEL_H
+
+#include <tcl/tcl.h>
+
+#include <utility>
+#include <string_view>
+#include <span>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <streambuf>
+#include <istream>
+#include <ostream>
+
+#include "xtcl_def.h"
+#include "xtcl_type.h"
+#include "xtcl_error.h"
+
+using namespace std::literals;
+
+namespace Xtcl
+{
+    namespace detail
+    {
+        // buffers of the channel arguments, kept per thread from one call to the next
+        class ChannelBuffers
+        {
+            struct Buffer
+            {
+                std::unique_ptr<char []> data;
+                std::size_t size;
+            };
+
+            // enough for the channel arguments of a call
+            static constexpr std::size_t const N {4};
+
+            std::vector<Buffer> buffers;
+
+            static ChannelBuffers & get()
+            {
+                thread_local ChannelBuffers pool {};
+                return pool;
+            }
+
+        public :
+
+            // not initialized
+            static std::unique_ptr<char []> acquire(std::size_t size)
+            {
+                auto & buffers = get().buffers;
+
+                auto i = std::ranges::find(buffers, size, &Buffer::size);
+                if (i == buffers.end())
+                {
+                    return std::unique_ptr<char []> {new char [size]};
+                }
+
+                auto data = std::move(i->data);
+                buffers.erase(i);
+                return data;
+            }
+
+            static void release(std::unique_ptr<char []> && data, std::size_t size)
+            {
+                auto & buffers = get().buffers;
+
+                if (buffers.size() < N)
+                {
+                    buffers.push_back({std::move(data), size});
+                }
+            }
+        };
+
+        // buffers bytes read from or written to a channel, without encoding conversion (see Tcl_Read and Tcl_Write),
+        // the buffer being taken on the first read or write
+        class ChannelBuf : public std::streambuf
+        {
+            Tcl_Channel chan;
+            std::unique_ptr<char []> buffer;
+            std::size_t size;
+            bool failed;
+            // no input available yet on a non-blocking channel, rather than its end
+            bool stalled;
+
+            char * data()
+            {
+                if (buffer == nullptr)
+                {
+                    buffer = ChannelBuffers::acquire(size);
+                }
+
+                return buffer.get();
+            }
+
+        public :
+
+            ChannelBuf(Tcl_Channel chan, std::size_t size) : chan {chan}, buffer {}, size {size}, failed {}, stalled {} {}
+
+            // only moved before the first read or write
+            ChannelBuf(ChannelBuf && buf) : chan {buf.chan}, buffer {std::move(buf.buffer)}, size {buf.size}, failed {buf.failed}, stalled {buf.stalled} {}
+
+            ~ChannelBuf()
+            {
+                if (buffer != nullptr)
+                {
+                    ChannelBuffers::release(std::move(buffer), size);
+                }
+            }
+
+            Tcl_Channel channel() const {return chan;}
+
+            bool error() const {return failed;}
+
+            bool blocked() const {return stalled;}
+
+            // next buffered bytes, empty at end of input, when no input is available yet, or on error
+            std::span<char const> chunk()
+            {
+                if ((gptr() == egptr()) and (underflow() == traits_type::eof()))
+                {
+                    return {};
+                }
+
+                std::span<char const> const bytes {gptr(), egptr()};
+                setg(eback(), egptr(), egptr());
+                return bytes;
+            }
+
+        protected :
+
+            int_type underflow() override
+            {
+                if (gptr() != egptr())
+                {
+                    return traits_type::to_int_type(*gptr());
+                }
+
+                int const n {Tcl_Read(chan, data(), int(size))};
+
+                // a non-blocking channel may have more input later, only a read at its end sets it as such
+                stalled = (n == 0) and (Tcl_Eof(chan) == 0) and (Tcl_InputBlocked(chan) != 0);
+
+                if (n <= 0)
+                {
+                    failed = failed or (n < 0);
+                    return traits_type::eof();
+                }
+
+                setg(data(), data(), data() + n);
+                return traits_type::to_int_type(*gptr());
+            }
+
+            int_type overflow(int_type c) override
+            {
+                if (pbase() == nullptr)
+                {
+                    setp(data(), data() + size);
+                }
+                else if (sync() != 0)
+                {
+                    return traits_type::eof();
+                }
+
+                if (not traits_type::eq_int_type(c, traits_type::eof()))
+                {
+                    *pptr() = traits_type::to_char_type(c);
+                    pbump(1);
+                }
+
+                return traits_type::not_eof(c);
+            }
+
+            int sync() override
+            {
+                if (pbase() == nullptr)
+                {
+                    return 0;
+                }
+
+                int const n {int(pptr() - pbase())};
+                bool const written {(n == 0) or (Tcl_Write(chan, pbase(), n) == n)};
+
+                // bytes that could not be written are dropped, rather than written again on the next flush
+                setp(data(), data() + size);
+
+                if (not written)
+                {
+                    failed = true;
+                    return -1;
+                }
+
+                return 0;
+            }
+        };
+
+        template <typename C>
+        FromResult<C> channel_from(Tcl_Interp * tcl, Tcl_Obj * obj, int required)
+        {
+            int mode;
+            Tcl_Channel chan = Tcl_GetChannel(tcl, Tcl_GetString(obj), &mode);
+
+            if ((chan == nullptr) or ((mode & required) == 0))
+            {
+#if XTCL_ERROR_TCL
+                if (chan == nullptr)
+                {
+                    return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+                }
+#endif
+                return type_error<C>(obj);
+            }
+
+            return C {chan};
+        }
+    }
+
+    // readable channel argument, read as a stream or by chunks, in constant memory
+    class InChannel : public std::istream
+    {
+        detail::ChannelBuf buf;
+
+    public :
+
+        explicit InChannel(Tcl_Channel chan, std::size_t size = XTCL_CHANNEL_BUFFER) : std::istream {nullptr}, buf {chan, size}
+        {
+            rdbuf(&buf);
+        }
+
+        InChannel(InChannel && in) : std::istream {std::move(in)}, buf {std::move(in.buf)}
+        {
+            set_rdbuf(&buf);
+        }
+
+        Tcl_Channel channel() const {return buf.channel();}
+
+        // whether the last read found no input available yet (non-blocking channel), rather than the end of input
+        bool blocked() const {return buf.blocked();}
+
+        // next bytes of the channel, valid until the next read, empty at end of input (eofbit) or when no input is
+        // available yet (failbit, cleared before reading again)
+        std::span<char const> chunk()
+        {
+            auto const bytes = buf.chunk();
+
+            if (bytes.empty())
+            {
+                setstate(buf.error() ? (std::ios::eofbit | std::ios::badbit) : buf.blocked() ? std::ios::failbit : std::ios::eofbit);
+            }
+
+            return bytes;
+        }
+    };
+
+    // writable channel argument, flushed to the channel when the function returns (see commit)
+    class OutChannel : public std::ostream
+    {
+        detail::ChannelBuf buf;
+
+    public :
+
+        explicit OutChannel(Tcl_Channel chan, std::size_t size = XTCL_CHANNEL_BUFFER) : std::ostream {nullptr}, buf {chan, size}
+        {
+            rdbuf(&buf);
+        }
+
+        OutChannel(OutChannel && out) : std::ostream {std::move(out)}, buf {std::move(out.buf)}
+        {
+            set_rdbuf(&buf);
+        }
+
+        // when not committed, e.g. out of a binding
+        ~OutChannel()
+        {
+            buf.pubsync();
+        }
+
+        Tcl_Channel channel() const {return buf.channel();}
+
+        // flushed once the function has returned, a failed write being the call's error
+        Result<void> commit()
+        {
+            if ((buf.pubsync() != 0) or buf.error())
+            {
+                setstate(std::ios::badbit);
+
+                return Error::generic
+                (
+                    [name = std::string {Tcl_GetChannelName(channel())}, msg = std::string {Tcl_ErrnoMsg(Tcl_GetErrno())}] (std::ostream & os)
+                    {
+                        os << "error writing \""sv << name << "\": "sv << msg;
+                    }
+                );
+            }
+
+            return {};
+        }
+    };
+
+    template <>
+    struct Type<InChannel>
+    {
+        static auto name() {return "<readable channel>"sv;}
+
+        static constexpr bool const stateful {true};
+
+        static FromResult<InChannel> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            return detail::channel_from<InChannel>(tcl, obj, TCL_READABLE);
+        }
+
+        static ToResult to(Tcl_Interp * tcl, InChannel const & in)
+        {
+            return Tcl_NewStringObj(Tcl_GetChannelName(in.channel()), -1);
+        }
+    };
+
+    template <>
+    struct Type<OutChannel>
+    {
+        static auto name() {return "<writable channel>"sv;}
+
+        static constexpr bool const stateful {true};
+
+        static FromResult<OutChannel> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            return detail::channel_from<OutChannel>(tcl, obj, TCL_WRITABLE);
+        }
+
+        static ToResult to(Tcl_Interp * tcl, OutChannel const & out)
+        {
+            return Tcl_NewStringObj(Tcl_GetChannelName(out.channel()), -1);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef XTCL_COMMAND_H
+#define XTCL_COMMAND_H
+
+#include <tcl/tcl.h>
+
+#include <utility>
+#include <string_view>
+#include <string>
+#include <array>
+
+#include "xtcl_def.h"
+#include "xtcl_type.h"
+#include "xtcl_error.h"
+
+using namespace std::literals;
+
+namespace Xtcl
+{
+    template <typename>
+    class Command;
+
+    // Tcl command called from C++: arguments are encoded with Xtcl::to, and the result decoded with Xtcl::from
+    template <typename R, typename ...As>
+    class Command<R(As...)>
+    {
+        static constexpr std::size_t const S {sizeof ...(As)};
+
+        Tcl_Interp * tcl;
+        // Tcl keeps the resolved command in the name's internal representation, and resolves it again when it is
+        // redefined, renamed or deleted, so that the same name object is passed to every call
+        Tcl_Obj * cmd;
+
+        template <std::size_t I, typename A, typename ...Bs>
+        Result<void> encode(Tcl_Obj * objv[], A && arg, Bs && ...args)
+        {
+            auto obj = Xtcl::to(tcl, std::forward<A>(arg));
+            if (not obj)
+            {
+                return Error::index(obj.error(), I);
+            }
+
+            Tcl_IncrRefCount(*obj);
+            objv[I + 1] = *obj;
+
+            if constexpr (sizeof ...(Bs) != 0)
+            {
+                if (auto r = encode<I + 1>(objv, std::forward<Bs>(args)...); not r)
+                {
+                    Tcl_DecrRefCount(*obj);
+                    return r;
+                }
+            }
+
+            return {};
+        }
+
+    public :
+
+        Command(Tcl_Interp * tcl, Tcl_Obj * name) : tcl {tcl}, cmd {name}
+        {
+            Tcl_IncrRefCount(cmd);
+        }
+
+        Command(Tcl_Interp * tcl, std::string_view name) : Command {tcl, Tcl_NewStringObj(name.data(), int(name.size()))} {}
+
+        Command(Command const & command) : Command {command.tcl, command.cmd} {}
+
+        Command & operator = (Command const & command)
+        {
+            Tcl_IncrRefCount(command.cmd);
+            Tcl_DecrRefCount(cmd);
+            tcl = command.tcl;
+            cmd = command.cmd;
+            return *this;
+        }
+
+        ~Command()
+        {
+            Tcl_DecrRefCount(cmd);
+        }
+
+        Tcl_Obj * name() const {return cmd;}
+
+        // evaluated in the current namespace, the interpreter's result being left as set by the command
+        Result<Value<R>> operator () (As ...args)
+        {
+            // on the stack, the command may call back into this object
+            std::array<Tcl_Obj *, S + 1> objv {cmd};
+
+            if constexpr (S != 0)
+            {
+                if (auto r = encode<0>(objv.data(), std::forward<As>(args)...); not r)
+                {
+                    return Error::forward(r.error());
+                }
+            }
+
+            int const code {Tcl_EvalObjv(tcl, int(S + 1), objv.data(), 0)};
+
+            for (std::size_t i = 1; i <= S; ++i)
+            {
+                Tcl_DecrRefCount(objv[i]);
+            }
+
+            if (code != TCL_OK)
+            {
+                return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+            }
+
+            if constexpr (std::is_void_v<R>)
+            {
+                return {};
+            }
+            else
+            {
+                return Xtcl::from<R>(tcl, Tcl_GetObjResult(tcl));
+            }
+        }
+    };
+
+    // callback argument, the name of a command
+    template <typename R, typename ...As>
+    struct Type<Command<R(As...)>>
+    {
+        static auto name() {return "<command>"sv;}
+
+        static constexpr bool const stateful {true};
+
+        static FromResult<Command<R(As...)>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            return Command<R(As...)> {tcl, obj};
+        }
+
+        static ToResult to(Tcl_Interp *, Command<R(As...)> const & command)
+        {
+            return command.name();
+        }
+    };
+}
+
+#endif
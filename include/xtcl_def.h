@@ -1,6 +1,8 @@
 #ifndef XTCL_DEF_H
 #define XTCL_DEF_H
 
+#include <version>
+
 #ifndef XTCL_SUPPORT_CSTRING
 #define XTCL_SUPPORT_CSTRING 1
 #endif
@@ -21,4 +23,82 @@
 #define XTCL_ERROR_TCL 0
 #endif
 
+// shared objects for booleans, Xtcl::Literal and integers in [XTCL_INTERN_INT_MIN, XTCL_INTERN_INT_MAX] results
+#ifndef XTCL_INTERN
+#define XTCL_INTERN 1
+#endif
+
+#ifndef XTCL_INTERN_INT_MIN
+#define XTCL_INTERN_INT_MIN -16
+#endif
+
+#ifndef XTCL_INTERN_INT_MAX
+#define XTCL_INTERN_INT_MAX 255
+#endif
+
+// size of the buffer of Xtcl::InChannel and Xtcl::OutChannel arguments
+#ifndef XTCL_CHANNEL_BUFFER
+#define XTCL_CHANNEL_BUFFER 65536
+#endif
+
+// number of Xtcl::Rest elements decoded without allocating
+#ifndef XTCL_REST_INLINE
+#define XTCL_REST_INLINE 8
+#endif
+
+// number of Xtcl::Cancel checks between two polls of the interpreter
+#ifndef XTCL_CANCEL_STRIDE
+#define XTCL_CANCEL_STRIDE 1024
+#endif
+
+#ifndef XTCL_SUPPORT_MDSPAN
+#ifdef __cpp_lib_mdspan
+#define XTCL_SUPPORT_MDSPAN 1
+#else
+#define XTCL_SUPPORT_MDSPAN 0
+#endif
+#endif
+
+#ifndef XTCL_LEAN_DISPATCH
+#define XTCL_LEAN_DISPATCH 0
+#endif
+
+// keeps the non-template dispatch and error helpers out of the per-signature code
+#if XTCL_LEAN_DISPATCH
+#if defined(_MSC_VER)
+#define XTCL_OUTLINE __declspec(noinline)
+#else
+#define XTCL_OUTLINE [[gnu::noinline]]
+#endif
+#else
+#define XTCL_OUTLINE
+#endif
+
+// 0: disabled, 1: ring buffer (see Xtcl::add_trace), 2: USDT probes (sys/sdt.h)
+#ifndef XTCL_TRACE
+#define XTCL_TRACE 0
+#endif
+
+#ifndef XTCL_TRACE_CAPACITY
+#define XTCL_TRACE_CAPACITY 65536
+#endif
+
+// converts large std::vector of numbers or strings on a thread pool (Tcl must be built with threads),
+// from XTCL_PARALLEL_THRESHOLD elements, on XTCL_PARALLEL_THREADS threads (0: one per hardware thread)
+#ifndef XTCL_PARALLEL
+#define XTCL_PARALLEL 0
+#endif
+
+#ifndef XTCL_PARALLEL_THRESHOLD
+#define XTCL_PARALLEL_THRESHOLD 65536
+#endif
+
+#ifndef XTCL_PARALLEL_THREADS
+#define XTCL_PARALLEL_THREADS 0
+#endif
+
+#ifndef XTCL_EXTERN_TEMPLATES
+#define XTCL_EXTERN_TEMPLATES 0
+#endif
+
 #endif
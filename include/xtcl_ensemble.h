@@ -0,0 +1,266 @@
+#ifndef XTCL_ENSEMBLE_H
+#define XTCL_ENSEMBLE_H
+
+#include <tcl/tcl.h>
+
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <string>
+#include <tuple>
+#include <array>
+#include <span>
+#include <sstream>
+
+#include "xtcl_package.h"
+
+using namespace std::literals;
+using namespace std::string_literals;
+
+namespace Xtcl
+{
+    namespace detail
+    {
+        // internal representation of a resolved subcommand word: its ensemble, and the serial of the subcommand,
+        // so that an ensemble allocated where a deleted one was does not match the words resolved by the latter
+        inline void subcommand_dup(Tcl_Obj * src, Tcl_Obj * dup)
+        {
+            dup->internalRep.twoPtrValue = src->internalRep.twoPtrValue;
+            dup->typePtr = src->typePtr;
+        }
+
+        // words are only resolved from their string, which is never invalidated
+        inline Tcl_ObjType const * subcommand_type()
+        {
+            static Tcl_ObjType const type {"xtcl::subcommand", nullptr, subcommand_dup, nullptr, nullptr};
+            return &type;
+        }
+
+        inline std::uintptr_t ensemble_serials(std::size_t n)
+        {
+            static std::atomic<std::uintptr_t> serial {};
+            return serial.fetch_add(n);
+        }
+
+        // one command dispatching its first word to the overload set of a subcommand
+        template <std::size_t ...Ss>
+        class EnsembleData
+        {
+            static constexpr std::size_t const N {sizeof ...(Ss)};
+            static constexpr std::size_t const S {std::max({std::size_t {1}, Ss...})};
+
+            std::array<std::string, N> stored;
+            std::array<std::string_view, N> names;
+            PerfectHash<N> hash;
+            std::tuple<std::array<Function, Ss>...> fns;
+            std::array<std::span<Function const>, N> subcommands;
+            // names in lexicographic order, for prefixes
+            std::array<std::size_t, N> sorted;
+            std::uintptr_t serial;
+#if XTCL_TRACE
+            std::array<Trace::Name, N> traces;
+#endif
+
+            static std::array<std::string_view, N> views(std::array<std::string, N> const & stored)
+            {
+                std::array<std::string_view, N> names {};
+                std::ranges::copy(stored, names.begin());
+                return names;
+            }
+
+            bool cached(Tcl_Obj * obj, std::size_t & i) const
+            {
+                if ((obj->typePtr != subcommand_type()) or (obj->internalRep.twoPtrValue.ptr1 != this))
+                {
+                    return false;
+                }
+
+                i = std::uintptr_t(obj->internalRep.twoPtrValue.ptr2) - serial;
+                return i < N;
+            }
+
+            void cache(Tcl_Obj * obj, std::size_t i) const
+            {
+                if ((obj->typePtr != nullptr) and (obj->typePtr->freeIntRepProc != nullptr))
+                {
+                    obj->typePtr->freeIntRepProc(obj);
+                }
+
+                obj->internalRep.twoPtrValue.ptr1 = const_cast<EnsembleData *>(this);
+                obj->internalRep.twoPtrValue.ptr2 = reinterpret_cast<void *>(serial + i);
+                obj->typePtr = subcommand_type();
+            }
+
+            // subcommand of which the word is the name or a unique prefix, or N
+            std::size_t lookup(std::string_view word) const
+            {
+                if (std::size_t const i {hash.find(names, word)}; i != N)
+                {
+                    return i;
+                }
+
+                if (word.empty())
+                {
+                    return N;
+                }
+
+                auto const first = std::ranges::lower_bound(sorted, word, {}, [this] (std::size_t i) {return names[i];});
+                if ((first == sorted.end()) or (not names[*first].starts_with(word)))
+                {
+                    return N;
+                }
+
+                // a name the hash could not place
+                if (names[*first] == word)
+                {
+                    return *first;
+                }
+
+                auto const next = first + 1;
+                return ((next == sorted.end()) or (not names[*next].starts_with(word))) ? *first : N;
+            }
+
+            int unknown(Tcl_Interp * tcl, Tcl_Obj * word) const
+            {
+                std::ostringstream os {};
+                os << "unknown or ambiguous subcommand \""sv << Tcl_GetString(word) << "\": must be "sv;
+                for (std::size_t k = 0; k < N; ++k)
+                {
+                    if (k != 0) os << ((k + 1 == N) ? ((N == 2) ? " or "sv : ", or "sv) : ", "sv);
+                    os << names[sorted[k]];
+                }
+
+                Tcl_SetObjResult(tcl, Tcl_NewStringObj(os.str().c_str(), -1));
+                Tcl_SetErrorCode(tcl, "TCL", "LOOKUP", "SUBCOMMAND", Tcl_GetString(word), nullptr);
+
+                return TCL_ERROR;
+            }
+
+        public :
+
+            template <typename ...Bs>
+            EnsembleData([[maybe_unused]] char const * name, Bs const & ...bindings) :
+                stored {std::string {bindings.name()}...},
+                names {views(stored)},
+                hash {names},
+                fns {bindings.functions()...},
+                subcommands {},
+                sorted {},
+                serial {ensemble_serials(N)}
+#if XTCL_TRACE
+                , traces {Trace::name((name + " "s + std::string {bindings.name()}).c_str())...}
+#endif
+            {
+                std::apply
+                (
+                    [this] (auto const & ...fs)
+                    {
+                        subcommands = {std::span<Function const> {fs}...};
+                    },
+                    fns
+                );
+
+                for (std::size_t i = 0; i < N; ++i) sorted[i] = i;
+                std::ranges::sort(sorted, {}, [this] (std::size_t i) {return names[i];});
+            }
+
+            // the names and the word representations point into the data
+            EnsembleData(EnsembleData const &) = delete;
+            EnsembleData & operator = (EnsembleData const &) = delete;
+
+            int call(Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[]) const
+            {
+                if (objc < 2)
+                {
+                    Tcl_WrongNumArgs(tcl, 1, objv, "subcommand ?arg ...?");
+                    return TCL_ERROR;
+                }
+
+                Tcl_Obj * word = objv[1];
+
+                std::size_t i;
+                if (not cached(word, i))
+                {
+                    int length;
+                    char const * s = Tcl_GetStringFromObj(word, &length);
+
+                    i = lookup({s, std::size_t(length)});
+                    if (i == N)
+                    {
+                        return unknown(tcl, word);
+                    }
+
+                    cache(word, i);
+                }
+
+#if XTCL_TRACE
+                Trace::Scope trace {traces[i]};
+#endif
+
+                if (subcommands[i].empty())
+                {
+                    return TCL_OK;
+                }
+
+                // the subcommand word takes the place of the command name in error messages
+                std::array<Error, S> errors {};
+
+                return call_functions(tcl, subcommands[i], std::span {errors}.first(subcommands[i].size()), objc - 1, objv + 1);
+            }
+        };
+
+        template <std::size_t ...Ss>
+        int call_ensemble(ClientData cdata, Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[])
+        {
+            return static_cast<EnsembleData<Ss...> const *>(cdata)->call(tcl, objc, objv);
+        }
+
+        template <std::size_t ...Ss>
+        void delete_ensemble(ClientData cdata)
+        {
+            delete static_cast<EnsembleData<Ss...> *>(cdata);
+        }
+
+        template <typename B>
+        struct Overloads;
+
+        template <typename ...Fs>
+        struct Overloads<Binding<Fs...>> : public std::integral_constant<std::size_t, sizeof ...(Fs)> {};
+
+        template <typename ...Bs>
+        int add_ensemble(Tcl_Interp * tcl, char const * name, Bs const & ...bindings)
+        {
+            using Data = EnsembleData<Overloads<Bs>::value...>;
+
+            std::array<std::string_view, sizeof ...(Bs)> names {bindings.name()...};
+            std::ranges::sort(names);
+            if (auto d = std::ranges::adjacent_find(names); d != names.end())
+            {
+                std::string const subcommand {*d};
+                Tcl_SetObjResult(tcl, Tcl_ObjPrintf("duplicate subcommand \"%s\" in ensemble \"%s\"", subcommand.c_str(), name));
+                return TCL_ERROR;
+            }
+
+            Tcl_CreateObjCommand(tcl, name, call_ensemble<Overloads<Bs>::value...>, new Data {name, bindings...}, delete_ensemble<Overloads<Bs>::value...>);
+            return TCL_OK;
+        }
+    }
+
+    // single command dispatching on its first word, the name or a unique prefix of one of the bindings
+    // (TCL_ERROR, and no command, when two bindings have the same name)
+    template <typename ...Bs>
+    int add_ensemble(Tcl_Interp * tcl, char const * name, Bs const & ...bindings)
+    {
+        return detail::add_ensemble(tcl, name, bindings...);
+    }
+
+    template <typename ...Bs>
+    int add_ensemble(Tcl_Interp * tcl, std::string const & name, Bs const & ...bindings)
+    {
+        return detail::add_ensemble(tcl, name.c_str(), bindings...);
+    }
+}
+
+#endif
@@ -80,7 +80,7 @@ namespace Xtcl
     };
 }
 
-std::ostream & operator << (std::ostream & os, Xtcl::Error const & error)
+inline std::ostream & operator << (std::ostream & os, Xtcl::Error const & error)
 {
     error(os);
     return os;
@@ -0,0 +1,21 @@
+// Type instantiations shared by every translation unit when XTCL_EXTERN_TEMPLATES is enabled.
+// No include guard: included with XTCL_TYPE_INSTANCE defined either as an explicit instantiation
+// declaration (xtcl_type.h) or definition (src/xtcl_instances.cpp).
+
+XTCL_TYPE_INSTANCE(std::vector<int>);
+XTCL_TYPE_INSTANCE(std::vector<long int>);
+XTCL_TYPE_INSTANCE(std::vector<float>);
+XTCL_TYPE_INSTANCE(std::vector<double>);
+XTCL_TYPE_INSTANCE(std::vector<std::string>);
+
+XTCL_TYPE_INSTANCE(std::set<int>);
+XTCL_TYPE_INSTANCE(std::set<std::string>);
+XTCL_TYPE_INSTANCE(std::unordered_set<int>);
+XTCL_TYPE_INSTANCE(std::unordered_set<std::string>);
+
+XTCL_TYPE_INSTANCE(std::map<std::string, int>);
+XTCL_TYPE_INSTANCE(std::map<std::string, double>);
+XTCL_TYPE_INSTANCE(std::map<std::string, std::string>);
+XTCL_TYPE_INSTANCE(std::unordered_map<std::string, int>);
+XTCL_TYPE_INSTANCE(std::unordered_map<std::string, double>);
+XTCL_TYPE_INSTANCE(std::unordered_map<std::string, std::string>);
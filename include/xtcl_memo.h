@@ -0,0 +1,326 @@
+#ifndef XTCL_MEMO_H
+#define XTCL_MEMO_H
+
+#include <tcl/tcl.h>
+
+#include <utility>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <array>
+#include <sstream>
+
+#include "xtcl.h"
+
+using namespace std::literals;
+using namespace std::string_literals;
+
+namespace Xtcl
+{
+    namespace detail
+    {
+        // bounded LRU cache of the results of a pure command, keyed on the canonical values of its arguments
+        class Memo
+        {
+            struct Entry
+            {
+                std::string key;
+                Tcl_Obj * result;
+            };
+
+            std::list<Entry> entries;
+            std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+            std::string probe;
+
+            void evict()
+            {
+                while (entries.size() > capacity)
+                {
+                    auto & e = entries.back();
+                    index.erase(e.key);
+                    Tcl_DecrRefCount(e.result);
+                    entries.pop_back();
+                    ++evictions;
+                }
+            }
+
+            static bool integer(Tcl_Obj * obj)
+            {
+                static Tcl_ObjType const * const types[] {Tcl_GetObjType("int"), Tcl_GetObjType("wideInt")};
+
+                return (obj->typePtr != nullptr) and ((obj->typePtr == types[0]) or (obj->typePtr == types[1]));
+            }
+
+        public :
+
+            std::size_t capacity;
+            std::size_t hits;
+            std::size_t misses;
+            std::size_t evictions;
+
+            Memo(std::size_t capacity) : entries {}, index {}, probe {}, capacity {capacity}, hits {}, misses {}, evictions {} {}
+
+            Memo(Memo const &) = delete;
+            Memo & operator = (Memo const &) = delete;
+
+            virtual ~Memo()
+            {
+                for (auto & e : entries)
+                {
+                    Tcl_DecrRefCount(e.result);
+                }
+            }
+
+            std::size_t size() const {return entries.size();}
+
+            void resize(std::size_t n)
+            {
+                capacity = n;
+                evict();
+            }
+
+            // length prefixed canonical values
+            XTCL_OUTLINE std::string_view key(int objc, Tcl_Obj * const objv[])
+            {
+                probe.clear();
+
+                for (int i = 1; i < objc; ++i)
+                {
+                    append(objv[i]);
+                }
+
+                return probe;
+            }
+
+            // lengths no string can have, telling internal representations apart from strings
+            static constexpr std::uint32_t const real {~std::uint32_t {}};
+            static constexpr std::uint32_t const list {~std::uint32_t {} - 1};
+
+            void append(std::uint32_t n)
+            {
+                probe.append(reinterpret_cast<char const *>(&n), sizeof (n));
+            }
+
+            // without a string representation, integers are formatted from their internal one (as they would be),
+            // doubles are kept bit-wise, and lists element by element
+            void append(Tcl_Obj * obj)
+            {
+                if (obj->bytes == nullptr)
+                {
+                    Tcl_WideInt w;
+                    double d;
+                    Tcl_Obj ** objv;
+                    int objc;
+
+                    if (integer(obj) and (Tcl_GetWideIntFromObj(nullptr, obj, &w) == TCL_OK))
+                    {
+                        std::array<char, 24> digits;
+                        std::size_t const size {std::size_t(std::to_chars(digits.begin(), digits.end(), w).ptr - digits.data())};
+                        append(std::uint32_t(size));
+                        probe.append(digits.data(), size);
+                        return;
+                    }
+
+                    if (holds(obj, double_type()) and (Tcl_GetDoubleFromObj(nullptr, obj, &d) == TCL_OK))
+                    {
+                        append(real);
+                        probe.append(reinterpret_cast<char const *>(&d), sizeof (d));
+                        return;
+                    }
+
+                    if (holds(obj, list_type()) and (Tcl_ListObjGetElements(nullptr, obj, &objc, &objv) == TCL_OK))
+                    {
+                        append(list);
+                        append(std::uint32_t(objc));
+                        for (int i = 0; i < objc; ++i) append(objv[i]);
+                        return;
+                    }
+                }
+
+                int length;
+                char const * s = Tcl_GetStringFromObj(obj, &length);
+                append(std::uint32_t(length));
+                probe.append(s, std::size_t(length));
+            }
+
+            XTCL_OUTLINE Tcl_Obj * find(std::string_view key)
+            {
+                auto i = index.find(key);
+                if (i == index.end())
+                {
+                    ++misses;
+                    return nullptr;
+                }
+
+                entries.splice(entries.begin(), entries, i->second);
+                ++hits;
+                return i->second->result;
+            }
+
+            XTCL_OUTLINE void insert(std::string_view key, Tcl_Obj * result)
+            {
+                if (capacity == 0)
+                {
+                    return;
+                }
+
+                Tcl_IncrRefCount(result);
+                entries.push_front({std::string {key}, result});
+                index.emplace(entries.front().key, entries.begin());
+
+                evict();
+            }
+        };
+
+        template <std::size_t S>
+        struct PureData : public Memo
+        {
+            CmdData<S> cmd;
+
+            PureData(std::size_t capacity, CmdData<S> && cmd) : Memo {capacity}, cmd {std::move(cmd)} {}
+        };
+
+        inline void delete_memo(ClientData cdata)
+        {
+            delete static_cast<Memo *>(cdata);
+        }
+
+        template <std::size_t S>
+        int call_pure_function(ClientData cdata, Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[])
+        {
+            auto & data = *static_cast<PureData<S> *>(static_cast<Memo *>(cdata));
+
+#if XTCL_TRACE
+            Trace::Scope trace {data.cmd.trace};
+#endif
+
+            auto key = data.key(objc, objv);
+
+            if (Tcl_Obj * result = data.find(key))
+            {
+                Tcl_SetObjResult(tcl, result);
+                return TCL_OK;
+            }
+
+            // the function may call back into this command, and reuse the probe
+            std::string const miss {key};
+            std::array<Error, S> errors {};
+
+            int const code {call_functions(tcl, data.cmd.fns, errors, objc, objv)};
+            if (code == TCL_OK)
+            {
+                data.insert(miss, Tcl_GetObjResult(tcl));
+            }
+
+            return code;
+        }
+
+        inline Tcl_Obj * memo_stats(Memo const & memo)
+        {
+            Tcl_Obj * dict = Tcl_NewDictObj();
+
+            auto put = [dict] (char const * name, std::size_t value)
+            {
+                Tcl_DictObjPut(nullptr, dict, Tcl_NewStringObj(name, -1), Tcl_NewWideIntObj(Tcl_WideInt(value)));
+            };
+
+            put("capacity", memo.capacity);
+            put("size", memo.size());
+            put("hits", memo.hits);
+            put("misses", memo.misses);
+            put("evictions", memo.evictions);
+
+            return dict;
+        }
+
+        // memo cmd ?capacity?: statistics of a pure command, after setting its capacity
+        inline int memo_command(ClientData, Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[])
+        {
+            if ((objc != 2) and (objc != 3))
+            {
+                Tcl_WrongNumArgs(tcl, 1, objv, "cmd ?capacity?");
+                return TCL_ERROR;
+            }
+
+            Tcl_CmdInfo info;
+            if ((Tcl_GetCommandInfo(tcl, Tcl_GetString(objv[1]), &info) == 0) or (info.deleteProc != delete_memo))
+            {
+                Tcl_SetObjResult(tcl, Tcl_ObjPrintf("\"%s\" is not a pure command", Tcl_GetString(objv[1])));
+                return TCL_ERROR;
+            }
+
+            auto & memo = *static_cast<Memo *>(info.deleteData);
+
+            if (objc == 3)
+            {
+                auto capacity = Xtcl::from<std::size_t>(tcl, objv[2]);
+                if (not capacity)
+                {
+                    std::ostringstream os {};
+                    os << capacity.error();
+                    Tcl_SetObjResult(tcl, Tcl_NewStringObj(os.str().c_str(), -1));
+                    return TCL_ERROR;
+                }
+
+                memo.resize(*capacity);
+            }
+
+            Tcl_SetObjResult(tcl, memo_stats(memo));
+
+            return TCL_OK;
+        }
+
+        template <typename F>
+        struct Pure;
+
+        // the result would also depend on what the arguments stand for, or the call would have side effects
+        template <typename R, typename ...As>
+        struct Pure<std::function<R(As...)>> : public std::bool_constant<((not Committed<Value<As>> and not Stateful<As>) and ...)> {};
+
+        template <typename ...Fs>
+        void add_pure_function(Tcl_Interp * tcl, char const * name, std::size_t capacity, Fs && ...fs)
+        {
+            constexpr std::size_t const S {sizeof ...(Fs)};
+
+            static_assert((Pure<decltype(std::function{std::declval<Fs>()})>::value and ...), "pure functions cannot take variables, channels nor commands");
+
+            auto * data = new PureData<S>
+            {
+                capacity,
+                CmdData<S>
+                {
+                    .fns = make_functions(std::forward<Fs>(fs)...),
+#if XTCL_TRACE
+                    .trace = Trace::name(name)
+#endif
+                }
+            };
+
+            Tcl_CreateObjCommand(tcl, name, call_pure_function<S>, static_cast<Memo *>(data), delete_memo);
+        }
+    }
+
+    // functions whose results only depend on their arguments, the last results (up to capacity) being reused
+    template <typename ...Fs>
+    void add_pure_function(Tcl_Interp * tcl, char const * name, std::size_t capacity, Fs && ...fs)
+    {
+        detail::add_pure_function(tcl, name, capacity, std::forward<Fs>(fs)...);
+    }
+
+    template <typename ...Fs>
+    void add_pure_function(Tcl_Interp * tcl, std::string const & name, std::size_t capacity, Fs && ...fs)
+    {
+        detail::add_pure_function(tcl, name.c_str(), capacity, std::forward<Fs>(fs)...);
+    }
+
+    // adds a command returning (and setting) the cache capacity and statistics of a pure command
+    inline void add_memo(Tcl_Interp * tcl, char const * name)
+    {
+        Tcl_CreateObjCommand(tcl, name, detail::memo_command, nullptr, nullptr);
+    }
+}
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef XTCL_OPTIONS_H
+#define XTCL_OPTIONS_H
+
+#include <tcl/tcl.h>
+
+#include <utility>
+#include <algorithm>
+#include <string_view>
+#include <string>
+#include <array>
+#include <sstream>
+
+#include "xtcl_def.h"
+#include "xtcl_type.h"
+#include "xtcl_error.h"
+
+using namespace std::literals;
+
+namespace Xtcl
+{
+    // trailing -option value arguments, decoded into the fields named by Fields<T>, missing ones keeping their default value
+    template <typename T>
+    requires Aggregate<T> and NamedFields<T>
+    class Options
+    {
+        T val;
+
+    public :
+
+        Options() : val {} {}
+
+        T & operator * () {return val;}
+        T const & operator * () const {return val;}
+
+        T * operator -> () {return &val;}
+        T const * operator -> () const {return &val;}
+    };
+
+    namespace detail
+    {
+        // field names prefixed with a dash, stored once per aggregate
+        template <typename T>
+        struct OptionNames
+        {
+            static constexpr std::size_t const N {Fields<T>::names.size()};
+
+            static constexpr auto const text {[]
+            {
+                std::array<char, [] {std::size_t n {}; for (std::string_view name : Fields<T>::names) n += name.size() + 1; return n;}()> text {};
+                auto i = text.begin();
+                for (std::string_view name : Fields<T>::names)
+                {
+                    *i++ = '-';
+                    i = std::ranges::copy(name, i).out;
+                }
+                return text;
+            }()};
+
+            static constexpr std::array<std::string_view, N> const names {[]
+            {
+                std::array<std::string_view, N> names {};
+                std::size_t offset {};
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    std::size_t const size {std::string_view {Fields<T>::names[i]}.size() + 1};
+                    names[i] = {text.data() + offset, size};
+                    offset += size;
+                }
+                return names;
+            }()};
+
+            static constexpr PerfectHash<N> const hash {names};
+
+            static_assert(hash.complete, "option names must be distinct");
+        };
+    }
+
+    // option names are looked up once per word, the result being kept as its internal representation
+    template <typename T>
+    class Type<Options<T>>
+    {
+        static constexpr std::size_t const N {detail::arity<T>()};
+
+        static_assert(Fields<T>::names.size() == N, "one name per field");
+
+        using Names = detail::OptionNames<T>;
+
+        using Tie = decltype (detail::tie<N>(std::declval<T &>()));
+
+        template <std::size_t I>
+        using Field = std::remove_reference_t<std::tuple_element_t<I, Tie>>;
+
+        static auto make_name()
+        {
+            std::ostringstream os {};
+            [&os] <std::size_t ...Is> (std::index_sequence<Is...>)
+            {
+                std::size_t i {};
+                ((os << (i++ == 0 ? ""sv : " "sv) << '?' << Names::names[Is] << ' ' << Type<Value<Field<Is>>>::name() << '?'), ...);
+            }
+            (std::make_index_sequence<N> {});
+            return os.str();
+        }
+
+        template <std::size_t I>
+        static bool decode(Tcl_Interp * tcl, Tcl_Obj * obj, Tie & fields, Error & error)
+        {
+            auto e = Xtcl::from<Field<I>>(tcl, obj);
+            if (not e)
+            {
+                error = std::move(e.error());
+                return false;
+            }
+            std::get<I>(fields) = std::move(*e);
+            return true;
+        }
+
+        // index of the option, or N
+        static std::size_t lookup(Tcl_Obj * obj)
+        {
+            if (detail::index_of(obj, Names::names.data()))
+            {
+                return std::uintptr_t(obj->internalRep.twoPtrValue.ptr2);
+            }
+
+            int length;
+            char const * bytes = Tcl_GetStringFromObj(obj, &length);
+
+            std::size_t const i {Names::hash.find(Names::names, {bytes, std::size_t(length)})};
+            if (i != N)
+            {
+                detail::index_set(obj, Names::names.data(), i);
+            }
+
+            return i;
+        }
+
+        static std::unexpected<Error> unknown(Tcl_Obj * obj)
+        {
+            return Error::generic
+            (
+                [name = std::string {Tcl_GetString(obj)}] (std::ostream & os)
+                {
+                    os << "bad option \""sv << name << "\": must be "sv;
+                    for (std::size_t i = 0; i < N; ++i)
+                    {
+                        if (i != 0) os << ((i + 1 == N) ? ((N == 2) ? " or "sv : ", or "sv) : ", "sv);
+                        os << Names::names[i];
+                    }
+                }
+            );
+        }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        static FromResult<Options<T>> from(Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[])
+        {
+            Options<T> options {};
+            Tie fields {detail::tie<N>(*options)};
+
+            for (int k = 0; k < objc; k += 2)
+            {
+                std::size_t const i {lookup(objv[k])};
+                if (i == N)
+                {
+                    return unknown(objv[k]);
+                }
+
+                if (k + 1 == objc)
+                {
+                    return Error::generic
+                    (
+                        [name = Names::names[i]] (std::ostream & os)
+                        {
+                            os << "missing value for option \""sv << name << '"';
+                        }
+                    );
+                }
+
+                Error error {};
+
+                if (not [&] <std::size_t ...Is> (std::index_sequence<Is...>)
+                {
+                    return ((i != Is or decode<Is>(tcl, objv[k + 1], fields, error)) and ...);
+                }
+                (std::make_index_sequence<N> {}))
+                {
+                    return Error::generic
+                    (
+                        [error = std::move(error), name = Names::names[i]] (std::ostream & os)
+                        {
+                            os << '[' << name << "] "sv << error;
+                        }
+                    );
+                }
+            }
+
+            return options;
+        }
+    };
+}
+
+#endif
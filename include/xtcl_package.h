@@ -0,0 +1,254 @@
+#ifndef XTCL_PACKAGE_H
+#define XTCL_PACKAGE_H
+
+#include <tcl/tcl.h>
+
+#include <utility>
+#include <algorithm>
+#include <string_view>
+#include <string>
+#include <tuple>
+#include <array>
+#include <span>
+#include <vector>
+
+#include "xtcl.h"
+
+using namespace std::literals;
+using namespace std::string_literals;
+
+namespace Xtcl
+{
+    namespace detail
+    {
+        struct LazyEntry
+        {
+            std::string_view name;
+            void const * binding;
+            void (* create)(void const *, Tcl_Interp *, char const *);
+        };
+
+        // per interpreter, an entry being dropped once its command is created, so that a renamed or deleted
+        // command is not created again
+        struct LazyData
+        {
+            std::vector<LazyEntry> entries;
+            Tcl_Obj * previous;
+        };
+
+        inline std::string_view unqualify(std::string_view name)
+        {
+            while (name.starts_with("::"sv))
+            {
+                name.remove_prefix(2);
+            }
+
+            return name;
+        }
+
+        inline LazyEntry const * lazy_lookup(std::span<LazyEntry const> entries, std::string_view name)
+        {
+            auto e = std::ranges::lower_bound(entries, name, {}, &LazyEntry::name);
+
+            return ((e != entries.end()) and (e->name == name)) ? &*e : nullptr;
+        }
+
+        // resolve a command name the way Tcl does, minus the namespace path: current namespace first, then global
+        inline LazyEntry const * lazy_find(Tcl_Interp * tcl, std::span<LazyEntry const> entries, std::string_view name)
+        {
+            if (name.starts_with("::"sv))
+            {
+                return lazy_lookup(entries, unqualify(name));
+            }
+
+            std::string_view ns {unqualify(Tcl_GetCurrentNamespace(tcl)->fullName)};
+
+            if (not ns.empty())
+            {
+                std::string qualified {ns};
+                qualified += "::"sv;
+                qualified += name;
+
+                if (auto e = lazy_lookup(entries, qualified))
+                {
+                    return e;
+                }
+            }
+
+            return lazy_lookup(entries, name);
+        }
+
+        inline int lazy_unknown(ClientData cdata, Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[])
+        {
+            auto & data = *static_cast<LazyData *>(cdata);
+
+            if (objc < 2)
+            {
+                Tcl_WrongNumArgs(tcl, 1, objv, "cmd ?arg ...?");
+                return TCL_ERROR;
+            }
+
+            if (auto e = lazy_find(tcl, data.entries, Tcl_GetString(objv[1])))
+            {
+                LazyEntry const entry {*e};
+                data.entries.erase(data.entries.begin() + (e - data.entries.data()));
+
+                std::string name {"::"s};
+                name += entry.name;
+
+                entry.create(entry.binding, tcl, name.c_str());
+
+                return Tcl_EvalObjv(tcl, objc - 1, objv + 1, 0);
+            }
+
+            if (data.previous == nullptr)
+            {
+                Tcl_SetObjResult(tcl, Tcl_ObjPrintf("invalid command name \"%s\"", Tcl_GetString(objv[1])));
+                Tcl_SetErrorCode(tcl, "TCL", "LOOKUP", "COMMAND", Tcl_GetString(objv[1]), nullptr);
+                return TCL_ERROR;
+            }
+
+            Tcl_Obj ** prefixv;
+            int prefixc;
+
+            if (Tcl_ListObjGetElements(tcl, data.previous, &prefixc, &prefixv) != TCL_OK)
+            {
+                return TCL_ERROR;
+            }
+
+            std::vector<Tcl_Obj *> words {prefixv, prefixv + prefixc};
+            words.insert(words.end(), objv + 1, objv + objc);
+
+            return Tcl_EvalObjv(tcl, int(words.size()), words.data(), 0);
+        }
+
+        inline void lazy_delete(ClientData cdata)
+        {
+            auto * data = static_cast<LazyData *>(cdata);
+
+            if (data->previous != nullptr)
+            {
+                Tcl_DecrRefCount(data->previous);
+            }
+
+            delete data;
+        }
+
+        // chain a handler to the global namespace unknown handler, so that commands are only created when first called
+        inline void lazy_install(Tcl_Interp * tcl, char const * package, std::span<LazyEntry const> entries)
+        {
+            std::string const name {"::xtcl::unknown::"s + package};
+
+            Tcl_CmdInfo info;
+            if (Tcl_GetCommandInfo(tcl, name.c_str(), &info) != 0)
+            {
+                return;
+            }
+
+            Tcl_Namespace * global = Tcl_GetGlobalNamespace(tcl);
+
+            Tcl_Obj * previous = Tcl_GetNamespaceUnknownHandler(tcl, global);
+            if (previous != nullptr)
+            {
+                Tcl_IncrRefCount(previous);
+            }
+
+            Tcl_CreateObjCommand(tcl, name.c_str(), lazy_unknown, new LazyData {{entries.begin(), entries.end()}, previous}, lazy_delete);
+
+            Tcl_SetNamespaceUnknownHandler(tcl, global, Tcl_NewStringObj(name.c_str(), int(name.size())));
+        }
+    }
+
+    template <typename ...Fs>
+    class Binding
+    {
+        std::string_view cmd;
+        std::tuple<Fs...> fns;
+
+    public :
+
+        Binding(std::string_view name, Fs ...fs) : cmd {name}, fns {std::move(fs)...} {}
+
+        std::string_view name() const
+        {
+            return detail::unqualify(cmd);
+        }
+
+        // overload set of the binding, when it is not a command of its own (see add_ensemble)
+        std::array<detail::Function, sizeof ...(Fs)> functions() const
+        {
+            return std::apply
+            (
+                [] (auto const & ...fs)
+                {
+                    return detail::make_functions(fs...);
+                },
+                fns
+            );
+        }
+
+        static void create(void const * binding, Tcl_Interp * tcl, char const * name)
+        {
+            std::apply
+            (
+                [tcl, name] (auto const & ...fs)
+                {
+                    detail::add_function(tcl, name, fs...);
+                },
+                static_cast<Binding const *>(binding)->fns
+            );
+        }
+    };
+
+    template <typename ...Fs>
+    Binding(std::string_view, Fs...) -> Binding<Fs...>;
+
+    template <typename ...Bs>
+    class Package
+    {
+        static constexpr std::size_t const S {sizeof ...(Bs)};
+
+        char const * pkg;
+        char const * version;
+        std::tuple<Bs...> bindings;
+        std::array<detail::LazyEntry, S> entries;
+
+    public :
+
+        Package(char const * name, char const * version, Bs ...bindings) : pkg {name}, version {version}, bindings {std::move(bindings)...}, entries {}
+        {
+            [this] <std::size_t ...Is> (std::index_sequence<Is...>)
+            {
+                entries = {detail::LazyEntry {std::get<Is>(this->bindings).name(), &std::get<Is>(this->bindings), &Bs::create}...};
+            }
+            (std::index_sequence_for<Bs...> {});
+
+            std::ranges::sort(entries, {}, &detail::LazyEntry::name);
+        }
+
+        // entries point into the bindings
+        Package(Package const &) = delete;
+        Package & operator = (Package const &) = delete;
+
+        int init(Tcl_Interp * tcl) const
+        {
+            if (Tcl_InitStubs(tcl, TCL_VERSION, 0) == nullptr)
+            {
+                return TCL_ERROR;
+            }
+
+            detail::lazy_install(tcl, pkg, entries);
+
+            return Tcl_PkgProvide(tcl, pkg, version);
+        }
+    };
+}
+
+#define XTCL_PACKAGE(prefix, name, version, ...) \
+    extern "C" DLLEXPORT int prefix##_Init(Tcl_Interp * tcl) \
+    { \
+        static Xtcl::Package const package {name, version __VA_OPT__(,) __VA_ARGS__}; \
+        return package.init(tcl); \
+    }
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef XTCL_PARALLEL_H
+#define XTCL_PARALLEL_H
+
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <latch>
+
+#include "xtcl_def.h"
+
+namespace Xtcl
+{
+    namespace detail
+    {
+        // worker threads shared by all the interpreters, started on first use
+        class Pool
+        {
+            std::mutex mutex;
+            std::condition_variable ready;
+            std::deque<std::function<void ()>> tasks;
+            std::vector<std::jthread> workers;
+
+            void work(std::stop_token stop)
+            {
+                for (;;)
+                {
+                    std::function<void ()> task;
+                    {
+                        std::unique_lock lock {mutex};
+                        ready.wait(lock, [this, &stop] {return stop.stop_requested() or not tasks.empty();});
+                        if (tasks.empty())
+                        {
+                            return;
+                        }
+                        task = std::move(tasks.front());
+                        tasks.pop_front();
+                    }
+                    task();
+                }
+            }
+
+            Pool(std::size_t threads) : mutex {}, ready {}, tasks {}, workers {}
+            {
+                for (std::size_t i = 0; i < threads; ++i)
+                {
+                    workers.emplace_back([this] (std::stop_token stop) {work(stop);});
+                }
+            }
+
+        public :
+
+            ~Pool()
+            {
+                {
+                    std::lock_guard lock {mutex};
+                    for (auto & w : workers) w.request_stop();
+                }
+                ready.notify_all();
+            }
+
+            static Pool & get()
+            {
+                static Pool pool {(XTCL_PARALLEL_THREADS != 0) ? std::size_t(XTCL_PARALLEL_THREADS) : std::max(1u, std::thread::hardware_concurrency())};
+                return pool;
+            }
+
+            std::size_t size() const {return workers.size();}
+
+            // f(begin, end) over [0, n) split into chunks, the calling thread taking the first one
+            void run(std::size_t n, std::function<void (std::size_t, std::size_t)> const & f)
+            {
+                if (n == 0)
+                {
+                    return;
+                }
+
+                std::size_t const chunk {(n + size()) / (size() + 1)};
+                std::size_t const chunks {(n + chunk - 1) / chunk};
+                std::latch done {std::ptrdiff_t(chunks - 1)};
+
+                {
+                    std::lock_guard lock {mutex};
+                    for (std::size_t c = 1; c < chunks; ++c)
+                    {
+                        tasks.emplace_back([&f, &done, begin = c * chunk, end = std::min(n, (c + 1) * chunk)] {f(begin, end); done.count_down();});
+                    }
+                }
+                ready.notify_all();
+
+                f(0, std::min(n, chunk));
+                done.wait();
+            }
+        };
+    }
+}
+
+#endif
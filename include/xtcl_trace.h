@@ -0,0 +1,302 @@
+#ifndef XTCL_TRACE_H
+#define XTCL_TRACE_H
+
+#include <tcl/tcl.h>
+
+#include <cstdint>
+#include <limits>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <deque>
+#include <string_view>
+#include <string>
+#include <array>
+#include <algorithm>
+#include <ostream>
+#include <iomanip>
+#include <fstream>
+
+#include "xtcl_def.h"
+
+#if XTCL_TRACE == 2
+#include <sys/sdt.h>
+#endif
+
+using namespace std::literals;
+
+namespace Xtcl
+{
+    namespace detail
+    {
+        struct Trace
+        {
+            using Clock = std::chrono::steady_clock;
+
+            struct Name
+            {
+                std::uint32_t id;
+                char const * text;
+            };
+
+            // timestamps of the command being called on this thread
+            struct Span
+            {
+                Name name;
+                std::int32_t overload;
+                Clock::time_point start;
+                Clock::time_point attempt;
+                Clock::time_point decoded;
+                Clock::time_point called;
+            };
+
+            static inline thread_local Span * current {};
+
+            static void mark(Clock::time_point Span::* phase)
+            {
+                if (current != nullptr)
+                {
+                    current->*phase = Clock::now();
+                }
+            }
+
+            static void overload(std::size_t i)
+            {
+                if (current != nullptr)
+                {
+                    current->overload = std::int32_t(i);
+                }
+            }
+
+            // command names are never released, so that events and probes can refer to them
+            static Name name(char const * cmd)
+            {
+                epoch();
+
+                std::lock_guard lock {names_mutex()};
+
+                auto & ns = names();
+                auto n = std::ranges::find(ns, cmd);
+                if (n == ns.end())
+                {
+                    ns.emplace_back(cmd);
+                    n = ns.end() - 1;
+                }
+                return {std::uint32_t(n - ns.begin()), n->c_str()};
+            }
+
+            static std::deque<std::string> & names()
+            {
+                static std::deque<std::string> names {};
+                return names;
+            }
+
+            static std::mutex & names_mutex()
+            {
+                static std::mutex mutex {};
+                return mutex;
+            }
+
+            static std::uint64_t ns(Clock::duration d)
+            {
+                return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+            }
+
+            // multi-producer ring buffer, slots being tagged with the sequence number of their event
+            struct Event
+            {
+                std::atomic<std::uint64_t> sequence;
+                std::atomic<std::uint64_t> start;
+                std::atomic<std::uint32_t> name;
+                std::atomic<std::int32_t> overload;
+                std::atomic<std::uint32_t> thread;
+                std::atomic<std::uint32_t> dispatch;
+                std::atomic<std::uint32_t> decode;
+                std::atomic<std::uint32_t> call;
+                std::atomic<std::uint32_t> encode;
+            };
+
+            static_assert((XTCL_TRACE_CAPACITY & (XTCL_TRACE_CAPACITY - 1)) == 0, "trace capacity must be a power of two");
+
+            struct Ring
+            {
+                std::atomic<std::uint64_t> head;
+                std::array<Event, XTCL_TRACE_CAPACITY> events;
+            };
+
+            static Ring & ring()
+            {
+                static Ring ring {};
+                return ring;
+            }
+
+            static Clock::time_point epoch()
+            {
+                static Clock::time_point const epoch {Clock::now()};
+                return epoch;
+            }
+
+            static std::uint32_t thread()
+            {
+                static std::atomic<std::uint32_t> threads {};
+                static thread_local std::uint32_t const thread {++threads};
+                return thread;
+            }
+
+            static std::uint32_t duration(Clock::time_point from, Clock::time_point to)
+            {
+                return std::uint32_t(std::min<std::uint64_t>(ns(to - from), std::numeric_limits<std::uint32_t>::max()));
+            }
+
+            static void record(Span const & span, Clock::time_point end)
+            {
+                bool const ok {span.overload >= 0};
+
+                std::uint32_t const dispatch {duration(span.start, ok ? span.attempt : end)};
+                std::uint32_t const decode {ok ? duration(span.attempt, span.decoded) : 0};
+                std::uint32_t const call {ok ? duration(span.decoded, span.called) : 0};
+                std::uint32_t const encode {ok ? duration(span.called, end) : 0};
+
+#if XTCL_TRACE == 2
+                DTRACE_PROBE6(xtcl, call, span.name.text, span.overload, dispatch, decode, call, encode);
+#else
+                auto & r = ring();
+                std::uint64_t const i {r.head.fetch_add(1, std::memory_order_relaxed)};
+                auto & e = r.events[i & (XTCL_TRACE_CAPACITY - 1)];
+
+                e.sequence.store(0, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                e.start.store(ns(span.start - epoch()), std::memory_order_relaxed);
+                e.name.store(span.name.id, std::memory_order_relaxed);
+                e.overload.store(span.overload, std::memory_order_relaxed);
+                e.thread.store(thread(), std::memory_order_relaxed);
+                e.dispatch.store(dispatch, std::memory_order_relaxed);
+                e.decode.store(decode, std::memory_order_relaxed);
+                e.call.store(call, std::memory_order_relaxed);
+                e.encode.store(encode, std::memory_order_relaxed);
+                e.sequence.store(i + 1, std::memory_order_release);
+#endif
+            }
+
+            // installed for the duration of a command call, restores the enclosing command's span
+            class Scope
+            {
+                Span span;
+                Span * previous;
+
+            public :
+
+                Scope(Name name) : span {name, -1, Clock::now()}, previous {current}
+                {
+                    current = &span;
+                }
+
+                ~Scope()
+                {
+                    current = previous;
+                    record(span, Clock::now());
+                }
+
+                Scope(Scope const &) = delete;
+                Scope & operator = (Scope const &) = delete;
+            };
+
+#if XTCL_TRACE != 2
+            // chrome://tracing (or Perfetto) JSON, oldest events first
+            static std::size_t dump(std::ostream & os)
+            {
+                auto & r = ring();
+                std::uint64_t const head {r.head.load(std::memory_order_acquire)};
+                std::uint64_t const first {(head > XTCL_TRACE_CAPACITY) ? head - XTCL_TRACE_CAPACITY : 0};
+                std::size_t count {};
+
+                std::lock_guard lock {names_mutex()};
+
+                auto us = [] (std::uint64_t ns) {return double(ns) / 1000.0;};
+
+                os << std::fixed << std::setprecision(3) << "{\"traceEvents\":["sv;
+
+                for (std::uint64_t i = first; i < head; ++i)
+                {
+                    auto & e = r.events[i & (XTCL_TRACE_CAPACITY - 1)];
+
+                    if (e.sequence.load(std::memory_order_acquire) != i + 1) continue;
+
+                    std::uint64_t const start {e.start.load(std::memory_order_relaxed)};
+                    std::uint32_t const name {e.name.load(std::memory_order_relaxed)};
+                    std::int32_t const overload {e.overload.load(std::memory_order_relaxed)};
+                    std::uint32_t const thread {e.thread.load(std::memory_order_relaxed)};
+                    std::uint64_t const dispatch {e.dispatch.load(std::memory_order_relaxed)};
+                    std::uint64_t const decode {e.decode.load(std::memory_order_relaxed)};
+                    std::uint64_t const call {e.call.load(std::memory_order_relaxed)};
+                    std::uint64_t const encode {e.encode.load(std::memory_order_relaxed)};
+
+                    // overwritten while being read
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (e.sequence.load(std::memory_order_relaxed) != i + 1) continue;
+
+                    auto event = [&] (std::string_view phase, std::uint64_t ts, std::uint64_t dur)
+                    {
+                        if (count++ != 0) os << ',';
+                        os << "{\"name\":\""sv << phase << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"sv << thread
+                           << ",\"ts\":"sv << us(ts) << ",\"dur\":"sv << us(dur)
+                           << ",\"args\":{\"overload\":"sv << overload << "}}"sv;
+                    };
+
+                    // command names are plain Tcl words, only quotes and backslashes need escaping
+                    std::string cmd {};
+                    for (char c : names()[name])
+                    {
+                        if ((c == '"') or (c == '\\')) cmd += '\\';
+                        cmd += c;
+                    }
+
+                    event(cmd, start, dispatch + decode + call + encode);
+                    if (overload >= 0)
+                    {
+                        event("decode"sv, start + dispatch, decode);
+                        event("call"sv, start + dispatch + decode, call);
+                        event("encode"sv, start + dispatch + decode + call, encode);
+                    }
+                }
+
+                os << "]}"sv;
+
+                return count;
+            }
+
+            static int dump_command(ClientData, Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[])
+            {
+                if (objc != 2)
+                {
+                    Tcl_WrongNumArgs(tcl, 1, objv, "file");
+                    return TCL_ERROR;
+                }
+
+                std::ofstream os {Tcl_GetString(objv[1])};
+                if (not os)
+                {
+                    Tcl_SetObjResult(tcl, Tcl_ObjPrintf("couldn't open \"%s\"", Tcl_GetString(objv[1])));
+                    return TCL_ERROR;
+                }
+
+                std::size_t const count {dump(os)};
+
+                Tcl_SetObjResult(tcl, Tcl_NewWideIntObj(Tcl_WideInt(count)));
+
+                return TCL_OK;
+            }
+#endif
+        };
+    }
+
+#if XTCL_TRACE != 2
+    // adds a command writing the traced calls to a Chrome trace JSON file, and returning the number of events written
+    inline void add_trace(Tcl_Interp * tcl, char const * name)
+    {
+        Tcl_CreateObjCommand(tcl, name, detail::Trace::dump_command, nullptr, nullptr);
+    }
+#endif
+}
+
+#endif
@@ -12,10 +12,21 @@
 #include <tuple>
 #include <vector>
 #include <array>
+#include <span>
 #include <map>
 #include <unordered_map>
 #include <set>
 #include <unordered_set>
+#include <variant>
+#include <optional>
+#include <cstring>
+#include <algorithm>
+#include <concepts>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <atomic>
 
 // error handling
 #include <format>
@@ -25,6 +36,14 @@
 #include "xtcl_def.h"
 #include "xtcl_error.h"
 
+#if XTCL_SUPPORT_MDSPAN
+#include <mdspan>
+#endif
+
+#if XTCL_PARALLEL
+#include "xtcl_parallel.h"
+#endif
+
 using namespace std::literals;
 using namespace std::string_literals;
 
@@ -71,14 +90,93 @@ namespace Xtcl
         return Type<Value<T>>::from(tcl, obj);
     }
 
+    // rvalues are forwarded, so that containers can move their elements into their Tcl representation
     template <typename T>
-    auto to(Tcl_Interp * tcl, T const & value)
+    auto to(Tcl_Interp * tcl, T && value)
     {
-        return Type<Value<T>>::to(tcl, value);
+        return Type<Value<T>>::to(tcl, std::forward<T>(value));
     }
 
+    // types whose Tcl representation can be written into an existing unshared object
+    template <typename T>
+    concept Assignable = requires (Tcl_Obj * obj, T const & value)
+    {
+        Type<Value<T>>::assign(obj, value);
+    };
+
+    // arguments supplied by the binding instead of being decoded from a command word
+    template <typename T>
+    concept Injected = requires (Tcl_Interp * tcl)
+    {
+        {Type<Value<T>>::inject(tcl)} -> std::same_as<Value<T>>;
+    };
+
+    // last argument decoded from all the remaining command words
+    template <typename T>
+    concept Trailing = requires (Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[])
+    {
+        {Type<Value<T>>::from(tcl, objc, objv)} -> std::same_as<FromResult<Value<T>>>;
+    };
+
+    // types telling from its internal representation whether an object already holds one of their values
+    template <typename T>
+    concept Native = requires (Tcl_Obj * obj)
+    {
+        {Type<Value<T>>::native(obj)} -> std::same_as<bool>;
+    };
+
+    // arguments standing for the interpreter's state (channels, commands) rather than for a value
+    template <typename T>
+    concept Stateful = requires
+    {
+        requires Type<Value<T>>::stateful;
+    };
+
     namespace detail
     {
+        XTCL_OUTLINE inline std::unexpected<Error> arity_error(std::size_t expected, int objc)
+        {
+            return Error::generic
+            (
+                [expected, objc] (std::ostream &os)
+                {
+                    os << "wrong # args (expected "sv << expected << " but got "sv << objc << ')';
+                }
+            );
+        }
+
+        XTCL_OUTLINE inline std::unexpected<Error> min_arity_error(std::size_t expected, int objc)
+        {
+            return Error::generic
+            (
+                [expected, objc] (std::ostream &os)
+                {
+                    os << "wrong # args (expected at least "sv << expected << " but got "sv << objc << ')';
+                }
+            );
+        }
+
+        XTCL_OUTLINE inline std::unexpected<Error> max_arity_error(std::size_t expected, int objc)
+        {
+            return Error::generic
+            (
+                [expected, objc] (std::ostream &os)
+                {
+                    os << "wrong # args (expected at most "sv << expected << " but got "sv << objc << ')';
+                }
+            );
+        }
+
+        template <typename L, typename ...Ts>
+        struct Leading;
+
+        // trailing argument taking at most one word
+        template <typename T>
+        struct Optional : public std::false_type {};
+
+        template <typename T>
+        struct Optional<std::optional<T>> : public std::true_type {};
+
         template <typename ...Ts>
         class Tuple
         {
@@ -122,16 +220,28 @@ namespace Xtcl
             using Values = std::tuple<Value<Ts>...>;
             using Names = std::array<std::string_view, S>;
 
+            static constexpr bool const trailing {[]
+            {
+                if constexpr (S != 0)
+                {
+                    return Trailing<std::tuple_element_t<S - 1, Values>>;
+                }
+                else
+                {
+                    return false;
+                }
+            }()};
+
         private :
 
-            template <std::size_t I>
-            static ToResult to(Tcl_Interp * tcl, Tcl_Obj * obj, std::tuple<Ts...> const & values)
+            template <std::size_t I, typename V>
+            static ToResult to(Tcl_Interp * tcl, Tcl_Obj * obj, V && values)
             {
                 if constexpr (I != S)
                 {
                     static_assert(I < S);
 
-                    auto v = Xtcl::to(tcl, std::get<I>(values));
+                    auto v = Xtcl::to(tcl, std::get<I>(std::forward<V>(values)));
 
                     if (not v)
                     {
@@ -141,7 +251,7 @@ namespace Xtcl
 
                     Tcl_ListObjAppendElement(tcl, obj, *v);
 
-                    return to<I + 1>(tcl, obj, values);
+                    return to<I + 1>(tcl, obj, std::forward<V>(values));
                 }
                 else
                 {
@@ -158,26 +268,67 @@ namespace Xtcl
 
             static FromResult<Values> from(Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[])
             {
-                if (objc != S)
+                if constexpr (trailing)
                 {
-                    return Error::generic
-                    (
-                        [objc] (std::ostream &os)
+                    if (objc < int(S - 1))
+                    {
+                        return min_arity_error(S - 1, objc);
+                    }
+
+                    if constexpr (Optional<std::tuple_element_t<S - 1, Values>>::value)
+                    {
+                        if (objc > int(S))
                         {
-                            os << "wrong # args (expected "sv << S << " but got "sv << objc << ')';
+                            return max_arity_error(S, objc);
                         }
-                    );
+                    }
+
+                    auto leading = Leading<detail::Tuple<>, Ts...>::Tuple::from(tcl, int(S - 1), objv);
+                    if (not leading)
+                    {
+                        return Error::forward(leading.error());
+                    }
+
+                    auto last = Type<std::tuple_element_t<S - 1, Values>>::from(tcl, objc - int(S - 1), objv + (S - 1));
+                    if (not last)
+                    {
+                        return Error::index(last.error(), S - 1);
+                    }
+
+                    return std::tuple_cat(std::move(*leading), std::make_tuple(std::move(*last)));
                 }
+                else
+                {
+                    if (objc != S)
+                    {
+                        return arity_error(S, objc);
+                    }
 
-                return From<Value<Ts>...>::values(tcl, objv);
+                    return From<Value<Ts>...>::values(tcl, objv);
+                }
             }
 
             static ToResult to(Tcl_Interp * tcl, std::tuple<Ts...> const & values)
             {
                 return to<0>(tcl, Tcl_NewListObj(0, nullptr), values);
             }
+
+            static ToResult to(Tcl_Interp * tcl, std::tuple<Ts...> && values)
+            {
+                return to<0>(tcl, Tcl_NewListObj(0, nullptr), std::move(values));
+            }
+        };
+
+        // all the arguments but the last one
+        template <typename ...Ls, typename T>
+        struct Leading<Tuple<Ls...>, T>
+        {
+            using Tuple = detail::Tuple<Ls...>;
         };
 
+        template <typename ...Ls, typename T, typename U, typename ...Ts>
+        struct Leading<Tuple<Ls...>, T, U, Ts...> : public Leading<Tuple<Ls..., T>, U, Ts...> {};
+
         template <typename N>
         static auto type_error(Tcl_Obj * obj)
         {
@@ -204,10 +355,181 @@ namespace Xtcl
             };
         }
 
+        // frees an object created for a container that could not be completed, unless it is shared (interned)
+        inline void discard(Tcl_Obj * obj)
+        {
+            Tcl_IncrRefCount(obj);
+            Tcl_DecrRefCount(obj);
+        }
+
+        // internal representation of the values of the basic Tcl types (see Native)
+        inline bool holds(Tcl_Obj * obj, Tcl_ObjType const * type)
+        {
+            return (type != nullptr) and (obj->typePtr == type);
+        }
+
+        inline Tcl_ObjType const * int_type()
+        {
+            static Tcl_ObjType const * const type {Tcl_GetObjType("int")};
+            return type;
+        }
+
+        inline Tcl_ObjType const * double_type()
+        {
+            static Tcl_ObjType const * const type {Tcl_GetObjType("double")};
+            return type;
+        }
+
+        // not the type registered as "boolean", which is kept for compatibility, but the one of decoded booleans
+        inline Tcl_ObjType const * boolean_type()
+        {
+            static Tcl_ObjType const * const type {[]
+            {
+                Tcl_Obj * obj = Tcl_NewStringObj("false", 5);
+                int value;
+                Tcl_GetBooleanFromObj(nullptr, obj, &value);
+                Tcl_ObjType const * type {obj->typePtr};
+                discard(obj);
+                return type;
+            }()};
+            return type;
+        }
+
+        inline Tcl_ObjType const * list_type()
+        {
+            static Tcl_ObjType const * const type {Tcl_GetObjType("list")};
+            return type;
+        }
+
+        inline Tcl_ObjType const * dict_type()
+        {
+            static Tcl_ObjType const * const type {Tcl_GetObjType("dict")};
+            return type;
+        }
+
+        // empty string representation, only generated when the internal representation cannot tell
+        inline bool empty(Tcl_Obj * obj)
+        {
+            if (obj->bytes != nullptr)
+            {
+                return obj->length == 0;
+            }
+
+            if (holds(obj, int_type()) or holds(obj, double_type()) or holds(obj, boolean_type()))
+            {
+                return false;
+            }
+
+            int size;
+
+            if (holds(obj, list_type()) and (Tcl_ListObjLength(nullptr, obj, &size) == TCL_OK))
+            {
+                return size == 0;
+            }
+
+            if (holds(obj, dict_type()) and (Tcl_DictObjSize(nullptr, obj, &size) == TCL_OK))
+            {
+                return size == 0;
+            }
+
+            return Tcl_GetString(obj)[0] == '\0';
+        }
+
+#if XTCL_INTERN
+        // per-thread shared objects for small integers, booleans and literals, released when Tcl finalizes the thread
+        class Interned
+        {
+            static constexpr std::size_t const I {std::size_t(XTCL_INTERN_INT_MAX - XTCL_INTERN_INT_MIN + 1)};
+
+            std::array<Tcl_Obj *, I> integers;
+            std::array<Tcl_Obj *, 2> booleans;
+            // literals are told apart by address and size, a name may start a longer literal (XTCL_ENUM)
+            struct Address
+            {
+                std::size_t operator () (std::string_view s) const {return std::hash<void const *> {}(s.data()) ^ s.size();}
+                bool operator () (std::string_view a, std::string_view b) const {return (a.data() == b.data()) and (a.size() == b.size());}
+            };
+
+            std::unordered_map<std::string_view, Tcl_Obj *, Address, Address> literals;
+            bool released;
+
+            static void release(ClientData cdata)
+            {
+                auto & interned = *static_cast<Interned *>(cdata);
+
+                for (auto obj : interned.integers) if (obj != nullptr) Tcl_DecrRefCount(obj);
+                for (auto obj : interned.booleans) if (obj != nullptr) Tcl_DecrRefCount(obj);
+                for (auto [_, obj] : interned.literals) Tcl_DecrRefCount(obj);
+
+                interned.integers = {};
+                interned.booleans = {};
+                interned.literals.clear();
+                interned.released = true;
+            }
+
+            static Tcl_Obj * keep(Tcl_Obj * & slot, Tcl_Obj * obj)
+            {
+                Tcl_IncrRefCount(obj);
+                return slot = obj;
+            }
+
+            Interned() : integers {}, booleans {}, literals {}, released {}
+            {
+                Tcl_CreateThreadExitHandler(release, this);
+            }
+
+        public :
+
+            Interned(Interned const &) = delete;
+            Interned & operator = (Interned const &) = delete;
+
+            // objects still held when the thread exits without Tcl finalizing it are leaked, Tcl may be gone
+            static Interned & get()
+            {
+                static thread_local Interned interned {};
+                return interned;
+            }
+
+            static constexpr bool holds(std::integral auto value)
+            {
+                return std::cmp_greater_equal(value, XTCL_INTERN_INT_MIN) and std::cmp_less_equal(value, XTCL_INTERN_INT_MAX);
+            }
+
+            Tcl_Obj * integer(Tcl_WideInt value)
+            {
+                if (released) return Tcl_NewWideIntObj(value);
+
+                auto & obj = integers[std::size_t(value - XTCL_INTERN_INT_MIN)];
+                return (obj != nullptr) ? obj : keep(obj, Tcl_NewWideIntObj(value));
+            }
+
+            Tcl_Obj * boolean(bool value)
+            {
+                if (released) return Tcl_NewBooleanObj(value ? 1 : 0);
+
+                auto & obj = booleans[value ? 1 : 0];
+                return (obj != nullptr) ? obj : keep(obj, Tcl_NewBooleanObj(value ? 1 : 0));
+            }
+
+            Tcl_Obj * literal(std::string_view value)
+            {
+                if (released) return Tcl_NewStringObj(value.data(), int(value.size()));
+
+                auto & obj = literals[value];
+                return (obj != nullptr) ? obj : keep(obj, Tcl_NewStringObj(value.data(), int(value.size())));
+            }
+        };
+#endif
+
         template <typename N>
         requires std::is_integral_v<N>
         struct IntegralType
         {
+            static bool native(Tcl_Obj * obj)
+            {
+                return holds(obj, int_type());
+            }
+
             static FromResult<N> from(Tcl_Interp * tcl, Tcl_Obj * obj)
             {
                 Tcl_WideInt value;
@@ -252,14 +574,31 @@ namespace Xtcl
 
             static ToResult to(Tcl_Interp * tcl, N value)
             {
+#if XTCL_INTERN
+                // promoted, std::cmp_* do not take character types
+                if (Interned::holds(+value))
+                {
+                    return Interned::get().integer(Tcl_WideInt(value));
+                }
+#endif
                 return Tcl_NewWideIntObj(Tcl_WideInt(value));
             }
+
+            static void assign(Tcl_Obj * obj, N value)
+            {
+                Tcl_SetWideIntObj(obj, Tcl_WideInt(value));
+            }
         };
 
         template <typename N>
         requires std::is_floating_point_v<N>
         struct FloatingType
         {
+            static bool native(Tcl_Obj * obj)
+            {
+                return holds(obj, double_type());
+            }
+
             static FromResult<N> from(Tcl_Interp * tcl, Tcl_Obj * obj)
             {
                 double value;
@@ -280,6 +619,11 @@ namespace Xtcl
             {
                 return Tcl_NewDoubleObj(double(value));
             }
+
+            static void assign(Tcl_Obj * obj, N value)
+            {
+                Tcl_SetDoubleObj(obj, double(value));
+            }
         };
 
         template <template <typename> typename S, typename T>
@@ -380,7 +724,9 @@ namespace Xtcl
                 return map;
             }
 
-            static ToResult to(Tcl_Interp * tcl, M<K, V> const & map)
+            // values are moved from an rvalue map, keys being const
+            template <typename Mv>
+            static ToResult to(Tcl_Interp * tcl, Mv && map)
             {
                 Tcl_Obj * dict = Tcl_NewDictObj();
 
@@ -392,9 +738,10 @@ namespace Xtcl
                         Tcl_DecrRefCount(dict);
                         return Error::forward(k.error());
                     }
-                    auto v = Xtcl::to(tcl, value);
+                    auto v = Xtcl::to(tcl, std::forward_like<Mv>(value));
                     if (not v)
                     {
+                        discard(*k);
                         Tcl_DecrRefCount(dict);
                         return Error::forward(v.error());
                     }
@@ -474,6 +821,44 @@ namespace Xtcl
         }
     };
 
+    // string literal result, that can be shared instead of being copied into a new object on each call
+    class Literal
+    {
+        std::string_view value;
+
+    public :
+
+        template <std::size_t N>
+        consteval Literal(char const (& s)[N]) : value {s, N - 1} {}
+
+        consteval Literal(char const * s, std::size_t n) : value {s, n} {}
+
+        std::string_view view() const {return value;}
+    };
+
+    inline namespace literals
+    {
+        consteval Literal operator ""_tcl(char const * s, std::size_t n)
+        {
+            return Literal {s, n};
+        }
+    }
+
+    template <>
+    struct Type<Literal>
+    {
+        static auto name() {return "<string>"sv;}
+
+        static ToResult to(Tcl_Interp * tcl, Literal const & s)
+        {
+#if XTCL_INTERN
+            return detail::Interned::get().literal(s.view());
+#else
+            return Tcl_NewStringObj(s.view().data(), int(s.view().size()));
+#endif
+        }
+    };
+
 #if XTCL_SUPPORT_CSTRING
     template <>
     struct Type<char const *>
@@ -500,6 +885,11 @@ namespace Xtcl
             return "<bool>"sv;
         }
 
+        static bool native(Tcl_Obj * obj)
+        {
+            return detail::holds(obj, detail::boolean_type());
+        }
+
         static FromResult<bool> from(Tcl_Interp * tcl, Tcl_Obj * obj)
         {
             int value;
@@ -518,69 +908,154 @@ namespace Xtcl
 
         static ToResult to(Tcl_Interp * tcl, bool value)
         {
+#if XTCL_INTERN
+            return detail::Interned::get().boolean(value);
+#else
             return Tcl_NewBooleanObj(value ? 1 : 0);
+#endif
         }
-    };
 
-    template <typename T>
-    class Type<std::vector<T>>
-    {
-        static auto make_name()
+        static void assign(Tcl_Obj * obj, bool value)
         {
-            return std::format("<vector {}>"sv, Type<T>::name());
+            Tcl_SetBooleanObj(obj, value ? 1 : 0);
         }
+    };
 
-    public :
-
-        static auto name()
+#if XTCL_PARALLEL
+    namespace detail
+    {
+        // element types converted on the pool: the elements are only read, through private copies of their objects,
+        // and the new elements are created by the interpreter thread and only assigned a value (not bool, whose vector
+        // packs several elements in a word)
+        template <typename T>
+        concept Concurrent = (std::is_arithmetic_v<T> and not std::same_as<T, bool>) or std::same_as<T, std::string>;
+
+        // internal representations that can be copied bit-wise
+        inline bool plain(Tcl_Obj * obj)
         {
-            static std::string const name {make_name()};
-            return std::string_view {name};
+            return (obj->typePtr == nullptr) or ((obj->typePtr->freeIntRepProc == nullptr) and (obj->typePtr->dupIntRepProc == nullptr));
         }
 
-        static FromResult<std::vector<T>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        template <typename T>
+        FromResult<std::vector<T>> parallel_from(Tcl_Interp * tcl, std::size_t objc, Tcl_Obj * const objv[])
         {
-            Tcl_Obj **objv;
-            int objc;
-
-            if (Tcl_ListObjGetElements(tcl, obj, &objc, &objv) != TCL_OK)
+            // string representations the workers may need are generated here
+            for (std::size_t i = 0; i < objc; ++i)
             {
-#if XTCL_ERROR_TCL
-                return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
-#else
-                return detail::type_error<std::vector<T>>(obj);
-#endif
+                if ((objv[i]->bytes == nullptr) and (std::same_as<T, std::string> or not plain(objv[i])))
+                {
+                    Tcl_GetString(objv[i]);
+                }
             }
 
-            std::vector<T> vec {};
-            vec.reserve(objc);
+            std::vector<T> vec(objc);
+            std::atomic<std::size_t> failed {objc};
 
-            for (std::size_t i = 0; i < objc; ++i)
+            Pool::get().run(objc, [objv, &vec, &failed] (std::size_t begin, std::size_t end)
             {
-                auto e = Xtcl::from<T>(tcl, objv[i]);
-                if (e)
+                for (std::size_t i = begin; i < end; ++i)
                 {
-                    vec.push_back(std::move(*e));
+                    Tcl_Obj * e = objv[i];
+
+                    Tcl_Obj copy {};
+                    copy.refCount = 1;
+                    copy.bytes = e->bytes;
+                    copy.length = e->length;
+                    if (plain(e))
+                    {
+                        copy.typePtr = e->typePtr;
+                        copy.internalRep = e->internalRep;
+                    }
+
+                    bool ok {};
+                    if (auto v = Xtcl::from<T>(nullptr, &copy))
+                    {
+                        vec[i] = std::move(*v);
+                        ok = true;
+                    }
+
+                    if ((copy.typePtr != nullptr) and (copy.typePtr->freeIntRepProc != nullptr))
+                    {
+                        copy.typePtr->freeIntRepProc(&copy);
+                    }
+                    if (copy.bytes != e->bytes)
+                    {
+                        Tcl_Free(copy.bytes);
+                    }
+
+                    if (not ok)
+                    {
+                        // the lowest failing index, whatever the order the chunks are run in
+                        std::size_t f {failed.load()};
+                        while ((i < f) and not failed.compare_exchange_weak(f, i));
+                        return;
+                    }
                 }
-                else
+            });
+
+            // decoded again with the interpreter, for its error message: should it succeed this time, the elements left
+            // by the chunks that stopped are decoded here
+            for (std::size_t i {failed.load()}; i < objc; ++i)
+            {
+                auto e = Xtcl::from<T>(tcl, objv[i]);
+                if (not e)
                 {
                     return Error::index(e.error(), i);
                 }
+                vec[i] = std::move(*e);
             }
 
             return vec;
         }
 
-        static ToResult to(Tcl_Interp * tcl, std::vector<T> const & vec)
+        template <typename T>
+        Tcl_Obj * parallel_to(std::vector<T> const & vec)
         {
-            Tcl_Obj * list = Tcl_NewListObj(0, nullptr);
+            std::vector<Tcl_Obj *> objs(vec.size());
+            for (auto & obj : objs)
+            {
+                obj = Tcl_NewObj();
+            }
 
-            for (auto & e : vec)
+            Pool::get().run(vec.size(), [&vec, &objs] (std::size_t begin, std::size_t end)
             {
-                auto obj = Xtcl::to(tcl, e);
-                if (not obj)
+                for (std::size_t i = begin; i < end; ++i)
                 {
-                    Tcl_DecrRefCount(list);
+                    if constexpr (std::same_as<T, std::string>)
+                    {
+                        Tcl_SetStringObj(objs[i], vec[i].data(), int(vec[i].size()));
+                    }
+                    else
+                    {
+                        Type<T>::assign(objs[i], vec[i]);
+                    }
+                }
+            });
+
+            return Tcl_NewListObj(int(objs.size()), objs.data());
+        }
+    }
+#endif
+
+    template <typename T>
+    class Type<std::vector<T>>
+    {
+        static auto make_name()
+        {
+            return std::format("<vector {}>"sv, Type<T>::name());
+        }
+
+        template <typename V>
+        static ToResult to_list(Tcl_Interp * tcl, V && vec)
+        {
+            Tcl_Obj * list = Tcl_NewListObj(0, nullptr);
+
+            for (auto & e : vec)
+            {
+                auto obj = Xtcl::to(tcl, std::forward_like<V>(e));
+                if (not obj)
+                {
+                    Tcl_DecrRefCount(list);
                     return Error::forward(obj.error());
                 }
                 Tcl_ListObjAppendElement(tcl, list, *obj);
@@ -588,6 +1063,90 @@ namespace Xtcl
 
             return list;
         }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        static bool native(Tcl_Obj * obj)
+        {
+            return detail::holds(obj, detail::list_type());
+        }
+
+        static FromResult<std::vector<T>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            Tcl_Obj **objv;
+            int objc;
+
+            if (Tcl_ListObjGetElements(tcl, obj, &objc, &objv) != TCL_OK)
+            {
+#if XTCL_ERROR_TCL
+                return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+#else
+                return detail::type_error<std::vector<T>>(obj);
+#endif
+            }
+
+#if XTCL_PARALLEL and not XTCL_ERROR_TCL
+            if constexpr (detail::Concurrent<T>)
+            {
+                if (objc >= XTCL_PARALLEL_THRESHOLD)
+                {
+                    return detail::parallel_from<T>(tcl, std::size_t(objc), objv);
+                }
+            }
+#endif
+
+            std::vector<T> vec {};
+            vec.reserve(objc);
+
+            for (std::size_t i = 0; i < objc; ++i)
+            {
+                auto e = Xtcl::from<T>(tcl, objv[i]);
+                if (e)
+                {
+                    vec.push_back(std::move(*e));
+                }
+                else
+                {
+                    return Error::index(e.error(), i);
+                }
+            }
+
+            return vec;
+        }
+
+        static ToResult to(Tcl_Interp * tcl, std::vector<T> const & vec)
+        {
+#if XTCL_PARALLEL
+            if constexpr (detail::Concurrent<T>)
+            {
+                if (vec.size() >= XTCL_PARALLEL_THRESHOLD)
+                {
+                    return detail::parallel_to(vec);
+                }
+            }
+#endif
+            return to_list(tcl, vec);
+        }
+
+        static ToResult to(Tcl_Interp * tcl, std::vector<T> && vec)
+        {
+#if XTCL_PARALLEL
+            if constexpr (detail::Concurrent<T>)
+            {
+                if (vec.size() >= XTCL_PARALLEL_THRESHOLD)
+                {
+                    return detail::parallel_to(vec);
+                }
+            }
+#endif
+            return to_list(tcl, std::move(vec));
+        }
     };
 
     template <typename T, std::size_t S>
@@ -598,6 +1157,7 @@ namespace Xtcl
             return std::format("<array {} x {}>"sv, Type<T>::name(), S);
         }
 
+        // element types that cannot be default initialized are decoded through a tuple
         template<size_t... Is>
         static auto to_tuple(std::array<T, S> const & array, std::index_sequence<Is...>) {return std::tuple {array[Is]...};}
 
@@ -606,6 +1166,25 @@ namespace Xtcl
         template<size_t... Is>
         static auto to_array(auto & tuple, std::index_sequence<Is...>) {return std::array<T, S> {std::move(std::get<Is>(tuple))...};}
 
+        template <typename A>
+        static ToResult to_list(Tcl_Interp * tcl, A && array)
+        {
+            std::array<Tcl_Obj *, S> objv {};
+
+            for (std::size_t i = 0; i < S; ++i)
+            {
+                auto e = Xtcl::to(tcl, std::forward_like<A>(array[i]));
+                if (not e)
+                {
+                    for (std::size_t j = 0; j < i; ++j) detail::discard(objv[j]);
+                    return Error::index(e.error(), i);
+                }
+                objv[i] = *e;
+            }
+
+            return Tcl_NewListObj(int(S), objv.data());
+        }
+
     public :
 
         static auto name()
@@ -614,21 +1193,67 @@ namespace Xtcl
             return std::string_view {name};
         }
 
-        static FromResult<std::array<T, S>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        static bool native(Tcl_Obj * obj)
         {
-            auto tuple = Xtcl::from<Tuple>(tcl, obj);
+            return detail::holds(obj, detail::list_type());
+        }
 
-            if (not tuple)
+        static FromResult<std::array<T, S>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            if constexpr (std::default_initializable<T>)
             {
-                return Error::forward(tuple.error());
+                Tcl_Obj **objv;
+                int objc;
+
+                if (Tcl_ListObjGetElements(tcl, obj, &objc, &objv) != TCL_OK)
+                {
+#if XTCL_ERROR_TCL
+                    return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+#else
+                    return detail::type_error<std::array<T, S>>(obj);
+#endif
+                }
+
+                if (objc != S)
+                {
+                    return detail::arity_error(S, objc);
+                }
+
+                std::array<T, S> array {};
+
+                for (std::size_t i = 0; i < S; ++i)
+                {
+                    auto e = Xtcl::from<T>(tcl, objv[i]);
+                    if (not e)
+                    {
+                        return Error::index(e.error(), i);
+                    }
+                    array[i] = std::move(*e);
+                }
+
+                return array;
             }
+            else
+            {
+                auto tuple = Xtcl::from<Tuple>(tcl, obj);
 
-            return to_array(*tuple, std::make_index_sequence<S> {});
+                if (not tuple)
+                {
+                    return Error::forward(tuple.error());
+                }
+
+                return to_array(*tuple, std::make_index_sequence<S> {});
+            }
         }
 
         static ToResult to(Tcl_Interp * tcl, std::array<T, S> const & array)
         {
-            return Xtcl::to(tcl, to_tuple(array, std::make_index_sequence<S> {}));
+            return to_list(tcl, array);
+        }
+
+        static ToResult to(Tcl_Interp * tcl, std::array<T, S> && array)
+        {
+            return to_list(tcl, std::move(array));
         }
     };
 
@@ -648,15 +1273,25 @@ namespace Xtcl
             return std::string_view {name};
         }
 
-        static auto from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        static bool native(Tcl_Obj * obj)
+        {
+            return detail::holds(obj, detail::dict_type());
+        }
+
+        static FromResult<std::map<K, V>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
         {
             return detail::Map<std::map, K, V>::from(tcl, obj);
         }
 
-        static auto to(Tcl_Interp * tcl, std::map<K, V> const & map)
+        static ToResult to(Tcl_Interp * tcl, std::map<K, V> const & map)
         {
             return detail::Map<std::map, K, V>::to(tcl, map);
         }
+
+        static ToResult to(Tcl_Interp * tcl, std::map<K, V> && map)
+        {
+            return detail::Map<std::map, K, V>::to(tcl, std::move(map));
+        }
     };
 
     template <typename K, typename V>
@@ -675,15 +1310,25 @@ namespace Xtcl
             return std::string_view {name};
         }
 
-        static auto from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        static bool native(Tcl_Obj * obj)
+        {
+            return detail::holds(obj, detail::dict_type());
+        }
+
+        static FromResult<std::unordered_map<K, V>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
         {
             return detail::Map<std::unordered_map, K, V>::from(tcl, obj);
         }
 
-        static auto to(Tcl_Interp * tcl, std::unordered_map<K, V> const & map)
+        static ToResult to(Tcl_Interp * tcl, std::unordered_map<K, V> const & map)
         {
             return detail::Map<std::unordered_map, K, V>::to(tcl, map);
         }
+
+        static ToResult to(Tcl_Interp * tcl, std::unordered_map<K, V> && map)
+        {
+            return detail::Map<std::unordered_map, K, V>::to(tcl, std::move(map));
+        }
     };
 
     template <typename T>
@@ -702,12 +1347,17 @@ namespace Xtcl
             return std::string_view {name};
         }
 
-        static auto from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        static bool native(Tcl_Obj * obj)
+        {
+            return detail::holds(obj, detail::list_type());
+        }
+
+        static FromResult<std::set<T>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
         {
             return detail::Set<std::set, T>::from(tcl, obj);
         }
 
-        static auto to(Tcl_Interp * tcl, std::set<T> const & set)
+        static ToResult to(Tcl_Interp * tcl, std::set<T> const & set)
         {
             return detail::Set<std::set, T>::to(tcl, set);
         }
@@ -729,12 +1379,17 @@ namespace Xtcl
             return std::string_view {name};
         }
 
-        static auto from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        static bool native(Tcl_Obj * obj)
+        {
+            return detail::holds(obj, detail::list_type());
+        }
+
+        static FromResult<std::unordered_set<T>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
         {
             return detail::Set<std::unordered_set, T>::from(tcl, obj);
         }
 
-        static auto to(Tcl_Interp * tcl, std::unordered_set<T> const & set)
+        static ToResult to(Tcl_Interp * tcl, std::unordered_set<T> const & set)
         {
             return detail::Set<std::unordered_set, T>::to(tcl, set);
         }
@@ -767,6 +1422,11 @@ namespace Xtcl
             return std::string_view {name};
         }
 
+        static bool native(Tcl_Obj * obj)
+        {
+            return detail::holds(obj, detail::list_type());
+        }
+
         static Result<std::tuple<Value<Ts>...>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
         {
             Tcl_Obj **objv;
@@ -788,7 +1448,1257 @@ namespace Xtcl
         {
             return Tuple::to(tcl, tuple);
         }
+
+        static ToResult to(Tcl_Interp * tcl, std::tuple<Ts...> && tuple)
+        {
+            return Tuple::to(tcl, std::move(tuple));
+        }
+    };
+}
+
+namespace Xtcl
+{
+    // trailing arguments, decoded from the remaining command words into an inline buffer (XTCL_REST_INLINE elements),
+    // or into a vector when there are more
+    template <typename T>
+    class Rest
+    {
+        static constexpr std::size_t const N {XTCL_REST_INLINE};
+
+        static_assert(N > 0, "XTCL_REST_INLINE must be positive");
+
+        alignas (T) std::byte buffer[N * sizeof (T)];
+        std::vector<T> heap;
+        T * first;
+        std::size_t count;
+
+        bool local() const {return heap.capacity() == 0;}
+
+        // within the capacity given on construction
+        void push_back(T && value)
+        {
+            if (local())
+            {
+                new (first + count) T {std::move(value)};
+            }
+            else
+            {
+                heap.push_back(std::move(value));
+            }
+            ++count;
+        }
+
+        friend class Type<Rest<T>>;
+
+    public :
+
+        explicit Rest(std::size_t capacity = 0) : heap {}, first {reinterpret_cast<T *>(buffer)}, count {}
+        {
+            if (capacity > N)
+            {
+                heap.reserve(capacity);
+                first = heap.data();
+            }
+        }
+
+        Rest(Rest && rest) : heap {std::move(rest.heap)}, first {reinterpret_cast<T *>(buffer)}, count {}
+        {
+            if (local())
+            {
+                for (T & e : rest)
+                {
+                    new (first + count++) T {std::move(e)};
+                }
+            }
+            else
+            {
+                first = heap.data();
+                count = std::exchange(rest.count, 0);
+                rest.first = reinterpret_cast<T *>(rest.buffer);
+            }
+        }
+
+        Rest(Rest const &) = delete;
+        Rest & operator = (Rest const &) = delete;
+
+        ~Rest()
+        {
+            if (local())
+            {
+                std::destroy_n(first, count);
+            }
+        }
+
+        std::size_t size() const {return count;}
+        bool empty() const {return count == 0;}
+
+        T & operator [] (std::size_t i) {return first[i];}
+        T const & operator [] (std::size_t i) const {return first[i];}
+
+        T * begin() {return first;}
+        T * end() {return first + count;}
+        T const * begin() const {return first;}
+        T const * end() const {return first + count;}
+
+        operator std::span<T> () {return {first, count};}
+        operator std::span<T const> () const {return {first, count};}
+    };
+
+    template <typename T>
+    class Type<Rest<T>>
+    {
+        static auto make_name()
+        {
+            return std::format("?{} ...?"sv, Type<T>::name());
+        }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        static FromResult<Rest<T>> from(Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[])
+        {
+            Rest<T> rest {std::size_t(objc)};
+
+            for (std::size_t i = 0; i < objc; ++i)
+            {
+                auto e = Xtcl::from<T>(tcl, objv[i]);
+                if (not e)
+                {
+                    return Error::index(e.error(), i);
+                }
+                rest.push_back(std::move(*e));
+            }
+
+            return rest;
+        }
     };
 }
 
+namespace Xtcl
+{
+    // argument that may be empty, or left out when it is the last one
+    template <typename T>
+    requires (not Trailing<T>)
+    class Type<std::optional<T>>
+    {
+        static auto make_name()
+        {
+            return std::format("?{}?"sv, Type<T>::name());
+        }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        static FromResult<std::optional<T>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            if (detail::empty(obj))
+            {
+                return std::optional<T> {};
+            }
+
+            auto e = Xtcl::from<T>(tcl, obj);
+            if (not e)
+            {
+                return Error::forward(e.error());
+            }
+
+            return std::optional<T> {std::move(*e)};
+        }
+
+        // at most one word, as checked with the arity
+        static FromResult<std::optional<T>> from(Tcl_Interp * tcl, int objc, Tcl_Obj * const objv[])
+        {
+            if (objc == 0)
+            {
+                return std::optional<T> {};
+            }
+
+            return from(tcl, objv[0]);
+        }
+
+        static ToResult to(Tcl_Interp * tcl, std::optional<T> const & value)
+        {
+            return value ? Xtcl::to(tcl, *value) : Tcl_NewObj();
+        }
+
+        static ToResult to(Tcl_Interp * tcl, std::optional<T> && value)
+        {
+            return value ? Xtcl::to(tcl, std::move(*value)) : Tcl_NewObj();
+        }
+    };
+
+    namespace detail
+    {
+        // types decoded from the string representation, whatever the internal one
+        template <typename T>
+        concept Textual = std::same_as<T, std::string> or std::same_as<T, std::string_view> or std::same_as<T, char const *>;
+    }
+
+    // one of several types, decoded once: the alternative holding the object's internal representation is tried
+    // first, then the others in order, those reading the string representation coming last when the object has none
+    template <typename ...Ts>
+    class Type<std::variant<Ts...>>
+    {
+        static constexpr std::size_t const S {sizeof ...(Ts)};
+
+        template <std::size_t I>
+        using Alternative = Value<std::variant_alternative_t<I, std::variant<Ts...>>>;
+
+        static auto make_name()
+        {
+            std::ostringstream os {};
+            os << '<';
+            std::size_t i {};
+            ((os << (i++ == 0 ? ""sv : " | "sv) << Type<Value<Ts>>::name()), ...);
+            os << '>';
+            return os.str();
+        }
+
+        template <std::size_t I>
+        static bool native(Tcl_Obj * obj)
+        {
+            if constexpr (Native<Alternative<I>>)
+            {
+                return Type<Alternative<I>>::native(obj);
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        template <std::size_t I>
+        static bool decode(Tcl_Interp * tcl, Tcl_Obj * obj, std::optional<std::variant<Ts...>> & value)
+        {
+            auto e = Xtcl::from<Alternative<I>>(tcl, obj);
+            if (not e)
+            {
+                return false;
+            }
+
+            value.emplace(std::in_place_index<I>, std::move(*e));
+            return true;
+        }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        static bool native(Tcl_Obj * obj)
+        {
+            return [obj] <std::size_t ...Is> (std::index_sequence<Is...>)
+            {
+                return (native<Is>(obj) or ...);
+            }
+            (std::index_sequence_for<Ts...> {});
+        }
+
+        static FromResult<std::variant<Ts...>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            std::optional<std::variant<Ts...>> value {};
+
+            [tcl, obj, &value] <std::size_t ...Is> (std::index_sequence<Is...>)
+            {
+                std::size_t first {S};
+                ((native<Is>(obj) and (first = Is, true)) or ...);
+
+                bool const deferred {obj->bytes == nullptr};
+
+                ((Is == first and decode<Is>(tcl, obj, value)) or ...)
+                or ((Is != first and not (deferred and detail::Textual<Alternative<Is>>) and decode<Is>(tcl, obj, value)) or ...)
+                or ((Is != first and deferred and detail::Textual<Alternative<Is>> and decode<Is>(tcl, obj, value)) or ...);
+            }
+            (std::index_sequence_for<Ts...> {});
+
+            if (not value)
+            {
+                return detail::type_error<std::variant<Ts...>>(obj);
+            }
+
+            return std::move(*value);
+        }
+
+        static ToResult to(Tcl_Interp * tcl, std::variant<Ts...> const & value)
+        {
+            return std::visit([tcl] (auto const & v) {return Xtcl::to(tcl, v);}, value);
+        }
+
+        static ToResult to(Tcl_Interp * tcl, std::variant<Ts...> && value)
+        {
+            return std::visit([tcl] (auto && v) {return Xtcl::to(tcl, std::move(v));}, std::move(value));
+        }
+    };
+}
+
+namespace Xtcl
+{
+    // optional field names of an aggregate, represented as a dictionary instead of a list when provided:
+    // template <> struct Xtcl::Fields<Vec2> {static constexpr std::array names {"x"sv, "y"sv};};
+    template <typename>
+    struct Fields {};
+
+    namespace detail
+    {
+        struct AnyField
+        {
+            template <typename T>
+            operator T () const;
+        };
+
+        template <typename T, typename ...As>
+        consteval std::size_t arity()
+        {
+            if constexpr (requires {T {As {}..., AnyField {}};})
+            {
+                return arity<T, As..., AnyField>();
+            }
+            else
+            {
+                return sizeof ...(As);
+            }
+        }
+
+        template <std::size_t N, typename T>
+        auto tie(T & value)
+        {
+            static_assert(N <= 16, "too many fields");
+
+            if constexpr (N == 0)
+            {
+                return std::tie();
+            }
+            else if constexpr (N == 1)
+            {
+                auto & [a] = value;
+                return std::tie(a);
+            }
+            else if constexpr (N == 2)
+            {
+                auto & [a, b] = value;
+                return std::tie(a, b);
+            }
+            else if constexpr (N == 3)
+            {
+                auto & [a, b, c] = value;
+                return std::tie(a, b, c);
+            }
+            else if constexpr (N == 4)
+            {
+                auto & [a, b, c, d] = value;
+                return std::tie(a, b, c, d);
+            }
+            else if constexpr (N == 5)
+            {
+                auto & [a, b, c, d, e] = value;
+                return std::tie(a, b, c, d, e);
+            }
+            else if constexpr (N == 6)
+            {
+                auto & [a, b, c, d, e, f] = value;
+                return std::tie(a, b, c, d, e, f);
+            }
+            else if constexpr (N == 7)
+            {
+                auto & [a, b, c, d, e, f, g] = value;
+                return std::tie(a, b, c, d, e, f, g);
+            }
+            else if constexpr (N == 8)
+            {
+                auto & [a, b, c, d, e, f, g, h] = value;
+                return std::tie(a, b, c, d, e, f, g, h);
+            }
+            else if constexpr (N == 9)
+            {
+                auto & [a, b, c, d, e, f, g, h, i] = value;
+                return std::tie(a, b, c, d, e, f, g, h, i);
+            }
+            else if constexpr (N == 10)
+            {
+                auto & [a, b, c, d, e, f, g, h, i, j] = value;
+                return std::tie(a, b, c, d, e, f, g, h, i, j);
+            }
+            else if constexpr (N == 11)
+            {
+                auto & [a, b, c, d, e, f, g, h, i, j, k] = value;
+                return std::tie(a, b, c, d, e, f, g, h, i, j, k);
+            }
+            else if constexpr (N == 12)
+            {
+                auto & [a, b, c, d, e, f, g, h, i, j, k, l] = value;
+                return std::tie(a, b, c, d, e, f, g, h, i, j, k, l);
+            }
+            else if constexpr (N == 13)
+            {
+                auto & [a, b, c, d, e, f, g, h, i, j, k, l, m] = value;
+                return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m);
+            }
+            else if constexpr (N == 14)
+            {
+                auto & [a, b, c, d, e, f, g, h, i, j, k, l, m, n] = value;
+                return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m, n);
+            }
+            else if constexpr (N == 15)
+            {
+                auto & [a, b, c, d, e, f, g, h, i, j, k, l, m, n, o] = value;
+                return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o);
+            }
+            else if constexpr (N == 16)
+            {
+                auto & [a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p] = value;
+                return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p);
+            }
+        }
+    }
+
+    template <typename T>
+    concept Aggregate = std::is_class_v<T> and std::is_aggregate_v<T> and std::default_initializable<T>;
+
+    template <typename T>
+    concept NamedFields = requires
+    {
+        {Fields<T>::names.size()} -> std::convertible_to<std::size_t>;
+    };
+
+    // aggregates are decoded into and encoded from their fields directly
+    template <typename T>
+    requires Aggregate<T>
+    class Type<T>
+    {
+        static constexpr std::size_t const N {detail::arity<T>()};
+
+        using Tie = decltype (detail::tie<N>(std::declval<T &>()));
+
+        template <std::size_t I>
+        using Field = std::remove_reference_t<std::tuple_element_t<I, Tie>>;
+
+        static constexpr bool const named {NamedFields<T>};
+
+        static auto make_name()
+        {
+            std::ostringstream os {};
+            os << "<struct"sv;
+            [&os] <std::size_t ...Is> (std::index_sequence<Is...>)
+            {
+                if constexpr (named)
+                {
+                    ((os << ' ' << Fields<T>::names[Is] << ' ' << Type<Value<Field<Is>>>::name()), ...);
+                }
+                else
+                {
+                    ((os << ' ' << Type<Value<Field<Is>>>::name()), ...);
+                }
+            }
+            (std::make_index_sequence<N> {});
+            os << '>';
+            return os.str();
+        }
+
+        template <std::size_t I>
+        static bool decode(Tcl_Interp * tcl, Tcl_Obj * obj, Tie & fields, Error & error)
+        {
+            auto e = Xtcl::from<Field<I>>(tcl, obj);
+            if (not e)
+            {
+                error = std::move(e.error());
+                return false;
+            }
+            std::get<I>(fields) = std::move(*e);
+            return true;
+        }
+
+        template <std::size_t I, typename V>
+        static bool encode(Tcl_Interp * tcl, V && value, Tcl_Obj * objv[], Error & error)
+        {
+            auto e = Xtcl::to(tcl, std::forward_like<V>(std::get<I>(detail::tie<N>(value))));
+            if (not e)
+            {
+                error = std::move(e.error());
+                return false;
+            }
+            objv[I] = *e;
+            return true;
+        }
+
+        template <std::size_t ...Is>
+        static FromResult<T> from_list(Tcl_Interp * tcl, Tcl_Obj * obj, std::index_sequence<Is...>)
+        {
+            Tcl_Obj **objv;
+            int objc;
+
+            if (Tcl_ListObjGetElements(tcl, obj, &objc, &objv) != TCL_OK)
+            {
+#if XTCL_ERROR_TCL
+                return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+#else
+                return detail::type_error<T>(obj);
+#endif
+            }
+
+            if (objc != N)
+            {
+                return detail::arity_error(N, objc);
+            }
+
+            T value {};
+            Tie fields {detail::tie<N>(value)};
+            Error error {};
+            std::size_t i {};
+
+            if (not ((i = Is, decode<Is>(tcl, objv[Is], fields, error)) and ...))
+            {
+                return Error::index(error, i);
+            }
+
+            return value;
+        }
+
+        template <std::size_t ...Is>
+        static FromResult<T> from_dict(Tcl_Interp * tcl, Tcl_Obj * obj, std::index_sequence<Is...>)
+        {
+            T value {};
+            Tie fields {detail::tie<N>(value)};
+            std::array<bool, N> found {};
+            Tcl_DictSearch search;
+            Tcl_Obj * key;
+            Tcl_Obj * field;
+            int done;
+
+            if (Tcl_DictObjFirst(tcl, obj, &search, &key, &field, &done) != TCL_OK)
+            {
+#if XTCL_ERROR_TCL
+                return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+#else
+                return detail::type_error<T>(obj);
+#endif
+            }
+
+            for (; done == 0; Tcl_DictObjNext(&search, &key, &field, &done))
+            {
+                int length;
+                char const * bytes = Tcl_GetStringFromObj(key, &length);
+                std::string_view const name {bytes, std::size_t(length)};
+
+                std::size_t const i = std::ranges::find(Fields<T>::names, name) - Fields<T>::names.begin();
+
+                if (i == N)
+                {
+                    Tcl_DictObjDone(&search);
+                    return Error::generic
+                    (
+                        [name = std::string {name}] (std::ostream & os)
+                        {
+                            os << "unknown field \""sv << name << '"';
+                        }
+                    );
+                }
+
+                Error error {};
+
+                if (not ((i != Is or decode<Is>(tcl, field, fields, error)) and ...))
+                {
+                    Tcl_DictObjDone(&search);
+                    return Error::generic
+                    (
+                        [error = std::move(error), name = Fields<T>::names[i]] (std::ostream & os)
+                        {
+                            os << '[' << name << "] "sv << error;
+                        }
+                    );
+                }
+
+                found[i] = true;
+            }
+
+            if (auto missing = std::ranges::find(found, false); missing != found.end())
+            {
+                return Error::generic
+                (
+                    [name = Fields<T>::names[missing - found.begin()]] (std::ostream & os)
+                    {
+                        os << "missing field \""sv << name << '"';
+                    }
+                );
+            }
+
+            return value;
+        }
+
+        template <typename V, std::size_t ...Is>
+        static ToResult to(Tcl_Interp * tcl, V && value, std::index_sequence<Is...>)
+        {
+            std::array<Tcl_Obj *, N> objv {};
+            Error error {};
+            std::size_t i {};
+
+            if (not ((i = Is, encode<Is>(tcl, std::forward<V>(value), objv.data(), error)) and ...))
+            {
+                for (std::size_t j = 0; j < i; ++j) detail::discard(objv[j]);
+                return Error::index(error, i);
+            }
+
+            if constexpr (named)
+            {
+                Tcl_Obj * dict = Tcl_NewDictObj();
+                for (std::size_t j = 0; j < N; ++j)
+                {
+                    auto const & name = Fields<T>::names[j];
+                    Tcl_DictObjPut(tcl, dict, Tcl_NewStringObj(name.data(), int(name.size())), objv[j]);
+                }
+                return dict;
+            }
+            else
+            {
+                return Tcl_NewListObj(int(N), objv.data());
+            }
+        }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        static FromResult<T> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            if constexpr (named)
+            {
+                return from_dict(tcl, obj, std::make_index_sequence<N> {});
+            }
+            else
+            {
+                return from_list(tcl, obj, std::make_index_sequence<N> {});
+            }
+        }
+
+        static ToResult to(Tcl_Interp * tcl, T const & value)
+        {
+            return to(tcl, value, std::make_index_sequence<N> {});
+        }
+
+        static ToResult to(Tcl_Interp * tcl, T && value)
+        {
+            return to(tcl, std::move(value), std::make_index_sequence<N> {});
+        }
+    };
+}
+
+namespace Xtcl
+{
+    // enumerators and their names, in the same order:
+    // template <> struct Xtcl::Enumerators<Color> {static constexpr std::array values {Color::red, Color::green}; static constexpr std::array names {"red"sv, "green"sv};};
+    // or XTCL_ENUM(Color, red, green);
+    template <typename>
+    struct Enumerators {};
+
+    template <typename E>
+    concept NamedEnum = std::is_enum_v<E> and requires
+    {
+        {Enumerators<E>::values.size()} -> std::convertible_to<std::size_t>;
+        {Enumerators<E>::names[0]} -> std::convertible_to<std::string_view>;
+    };
+
+    namespace detail
+    {
+        // splits the stringized enumerator list of XTCL_ENUM
+        template <std::size_t N>
+        consteval std::array<std::string_view, N> split_names(std::string_view list)
+        {
+            std::array<std::string_view, N> names {};
+
+            for (auto & name : names)
+            {
+                std::size_t const comma {std::min(list.find(','), list.size())};
+                name = list.substr(0, comma);
+                name.remove_prefix(std::min(name.find_first_not_of(' '), name.size()));
+                name.remove_suffix(name.size() - std::min(name.find_last_not_of(' ') + 1, name.size()));
+                list.remove_prefix(std::min(comma + 1, list.size()));
+            }
+
+            return names;
+        }
+
+        constexpr std::uint32_t name_hash(std::string_view name)
+        {
+            std::uint32_t h {2166136261u};
+            for (char c : name)
+            {
+                h = (h ^ std::uint8_t(c)) * 16777619u;
+            }
+            return h;
+        }
+
+        constexpr std::uint32_t name_slot(std::uint32_t h, std::uint32_t displacement)
+        {
+            h = (h ^ displacement) * 0x9E3779B1u;
+            return h ^ (h >> 16);
+        }
+
+        // hash and displace: the bucket of a name gives the displacement placing it in a slot of its own
+        // (built at compile time for enums, when an ensemble is added for its subcommands)
+        template <std::size_t N>
+        struct PerfectHash
+        {
+            static constexpr std::size_t const B {std::bit_ceil(std::max<std::size_t>(N, 1))};
+            static constexpr std::size_t const M {2 * B};
+
+            std::array<std::uint32_t, B> displacements;
+            std::array<std::size_t, M> slots;
+            // false when the names are not distinct (nothing is found then), or no displacement placed a bucket
+            bool complete;
+
+            constexpr PerfectHash(std::array<std::string_view, N> const & names) : displacements {}, slots {}, complete {true}
+            {
+                slots.fill(N);
+
+                auto sorted = names;
+                std::ranges::sort(sorted);
+                if (std::ranges::adjacent_find(sorted) != sorted.end())
+                {
+                    complete = false;
+                    return;
+                }
+
+                // names grouped by bucket: those of bucket b are members[starts[b]] to members[starts[b + 1]]
+                std::array<std::size_t, B + 1> starts {};
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    ++starts[(name_hash(names[i]) & (B - 1)) + 1];
+                }
+                for (std::size_t b = 0; b < B; ++b) starts[b + 1] += starts[b];
+
+                std::array<std::size_t, N> members {};
+                std::array<std::size_t, B> sizes {};
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    std::size_t const b {name_hash(names[i]) & (B - 1)};
+                    members[starts[b] + sizes[b]++] = i;
+                }
+
+                std::array<std::size_t, B> order {};
+                for (std::size_t b = 0; b < B; ++b) order[b] = b;
+                std::ranges::sort(order, std::ranges::greater {}, [&sizes] (std::size_t b) {return sizes[b];});
+
+                std::array<std::size_t, N> taken {};
+                for (std::size_t b : order)
+                {
+                    auto const bucket = std::span {members}.subspan(starts[b], sizes[b]);
+
+                    bool placed {false};
+                    for (std::uint32_t d = 0; (not placed) and (d < (1u << 20)); ++d)
+                    {
+                        bool free {true};
+                        for (std::size_t k = 0; free and (k < bucket.size()); ++k)
+                        {
+                            taken[k] = name_slot(name_hash(names[bucket[k]]), d) & (M - 1);
+                            free = (slots[taken[k]] == N) and (std::ranges::find(taken.begin(), taken.begin() + k, taken[k]) == taken.begin() + k);
+                        }
+
+                        if (free)
+                        {
+                            for (std::size_t k = 0; k < bucket.size(); ++k) slots[taken[k]] = bucket[k];
+                            displacements[b] = d;
+                            placed = true;
+                        }
+                    }
+
+                    complete = complete and placed;
+                }
+            }
+
+            // index of the name, or N
+            constexpr std::size_t find(std::array<std::string_view, N> const & names, std::string_view name) const
+            {
+                std::uint32_t const h {name_hash(name)};
+                std::size_t const i {slots[name_slot(h, displacements[h & (B - 1)]) & (M - 1)]};
+                return ((i != N) and (names[i] == name)) ? i : N;
+            }
+        };
+
+        // internal representation of a name resolved in a static table (enumerators, options): the table, and the name's index
+        inline void index_dup(Tcl_Obj * src, Tcl_Obj * dup)
+        {
+            dup->internalRep.twoPtrValue = src->internalRep.twoPtrValue;
+            dup->typePtr = src->typePtr;
+        }
+
+        inline void index_update(Tcl_Obj * obj)
+        {
+            auto const * names = static_cast<std::string_view const *>(obj->internalRep.twoPtrValue.ptr1);
+            auto const & name = names[std::uintptr_t(obj->internalRep.twoPtrValue.ptr2)];
+
+            obj->bytes = Tcl_Alloc(unsigned(name.size() + 1));
+            std::memcpy(obj->bytes, name.data(), name.size());
+            obj->bytes[name.size()] = '\0';
+            obj->length = int(name.size());
+        }
+
+        inline Tcl_ObjType const * index_type()
+        {
+            static Tcl_ObjType const type {"xtcl::index", nullptr, index_dup, index_update, nullptr};
+            return &type;
+        }
+
+        inline bool index_of(Tcl_Obj * obj, std::string_view const * names)
+        {
+            return (obj->typePtr == index_type()) and (obj->internalRep.twoPtrValue.ptr1 == names);
+        }
+
+        inline void index_set(Tcl_Obj * obj, std::string_view const * names, std::size_t i)
+        {
+            if ((obj->typePtr != nullptr) and (obj->typePtr->freeIntRepProc != nullptr))
+            {
+                obj->typePtr->freeIntRepProc(obj);
+            }
+
+            obj->internalRep.twoPtrValue.ptr1 = const_cast<std::string_view *>(names);
+            obj->internalRep.twoPtrValue.ptr2 = reinterpret_cast<void *>(std::uintptr_t(i));
+            obj->typePtr = index_type();
+        }
+    }
+
+    // enumerators are looked up by name once per object, the result being kept as its internal representation
+    template <typename E>
+    requires NamedEnum<E>
+    class Type<E>
+    {
+        static constexpr std::size_t const N {Enumerators<E>::values.size()};
+
+        static constexpr std::array<std::string_view, N> const names {[]
+        {
+            std::array<std::string_view, N> names {};
+            std::ranges::copy(Enumerators<E>::names, names.begin());
+            return names;
+        }()};
+
+        static constexpr detail::PerfectHash<N> const hash {names};
+
+        static_assert(Enumerators<E>::names.size() == N, "an enumerator name is required for each enumerator");
+        static_assert(hash.complete, "enumerator names must be distinct");
+
+        static auto make_name()
+        {
+            std::ostringstream os {};
+            os << '<';
+            for (auto [i, name] : std::views::enumerate(names))
+            {
+                if (i != 0) os << '|';
+                os << name;
+            }
+            os << '>';
+            return os.str();
+        }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        static bool native(Tcl_Obj * obj)
+        {
+            return detail::index_of(obj, names.data());
+        }
+
+        static FromResult<E> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            if (detail::index_of(obj, names.data()))
+            {
+                return Enumerators<E>::values[std::uintptr_t(obj->internalRep.twoPtrValue.ptr2)];
+            }
+
+            int length;
+            char const * s = Tcl_GetStringFromObj(obj, &length);
+
+            std::size_t const i {hash.find(names, std::string_view {s, std::size_t(length)})};
+            if (i == N)
+            {
+                return detail::type_error<E>(obj);
+            }
+
+            detail::index_set(obj, names.data(), i);
+
+            return Enumerators<E>::values[i];
+        }
+
+        static ToResult to(Tcl_Interp * tcl, E value)
+        {
+            std::size_t const i {std::size_t(std::ranges::find(Enumerators<E>::values, value) - Enumerators<E>::values.begin())};
+            if (i == N)
+            {
+                return Error::generic
+                (
+                    [value] (std::ostream & os)
+                    {
+                        os << "invalid "sv << Type<E>::name() << " value "sv << +std::to_underlying(value);
+                    }
+                );
+            }
+
+#if XTCL_INTERN
+            Tcl_Obj * obj = detail::Interned::get().literal(names[i]);
+#else
+            Tcl_Obj * obj = Tcl_NewStringObj(names[i].data(), int(names[i].size()));
+#endif
+            if (not detail::index_of(obj, names.data()))
+            {
+                detail::index_set(obj, names.data(), i);
+            }
+
+            return obj;
+        }
+    };
+}
+
+#define XTCL_ENUM(E, ...) \
+    template <> struct Xtcl::Enumerators<E> \
+    { \
+        using enum E; \
+        static constexpr std::array values {__VA_ARGS__}; \
+        static constexpr std::array names {Xtcl::detail::split_names<values.size()>(#__VA_ARGS__)}; \
+    }
+
+namespace Xtcl
+{
+    // row-major matrix stored in a single contiguous buffer
+    template <typename T>
+    class Matrix
+    {
+        std::size_t nrows;
+        std::size_t ncols;
+        std::vector<T> values;
+
+    public :
+
+        using value_type = T;
+        using index_type = std::size_t;
+
+        Matrix() : nrows {}, ncols {}, values {} {}
+
+        Matrix(std::size_t rows, std::size_t cols) : nrows {rows}, ncols {cols}, values(rows * cols) {}
+
+        // values are expected to hold rows * cols elements
+        Matrix(std::size_t rows, std::size_t cols, std::vector<T> && values) : nrows {rows}, ncols {cols}, values {std::move(values)} {}
+
+        static constexpr std::size_t rank() {return 2;}
+
+        std::size_t extent(std::size_t d) const {return (d == 0) ? nrows : ncols;}
+
+        std::size_t rows() const {return nrows;}
+        std::size_t cols() const {return ncols;}
+        std::size_t size() const {return values.size();}
+
+        T * data() {return values.data();}
+        T const * data() const {return values.data();}
+
+        T & operator [] (std::size_t r, std::size_t c) {return values[r * ncols + c];}
+        T const & operator [] (std::size_t r, std::size_t c) const {return values[r * ncols + c];}
+
+        std::span<T> row(std::size_t r) {return {values.data() + r * ncols, ncols};}
+        std::span<T const> row(std::size_t r) const {return {values.data() + r * ncols, ncols};}
+
+#if XTCL_SUPPORT_MDSPAN
+        std::mdspan<T, std::dextents<std::size_t, 2>> view() {return {values.data(), nrows, ncols};}
+        std::mdspan<T const, std::dextents<std::size_t, 2>> view() const {return {values.data(), nrows, ncols};}
+#endif
+    };
+
+    // matrix passed as a {rows cols bytes} list, bytes holding the values in native layout
+    template <typename T>
+    class Packed : public Matrix<T>
+    {
+        static_assert(std::is_arithmetic_v<T>, "packed matrices hold arithmetic values");
+
+    public :
+
+        using Matrix<T>::Matrix;
+
+        Packed(Matrix<T> && matrix) : Matrix<T> {std::move(matrix)} {}
+    };
+
+    namespace detail
+    {
+        // nested lists from anything providing rank(), extent() and a multidimensional [] (Matrix, mdspan)
+        template <typename M, std::size_t D = 0, typename ...Is>
+        ToResult to_nested(Tcl_Interp * tcl, M const & m, Is ...is)
+        {
+            if constexpr (D == M::rank())
+            {
+                return Xtcl::to(tcl, m[is...]);
+            }
+            else
+            {
+                std::size_t const n = m.extent(D);
+
+                std::vector<Tcl_Obj *> objv {};
+                objv.reserve(n);
+
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    auto obj = to_nested<M, D + 1>(tcl, m, is..., static_cast<typename M::index_type>(i));
+                    if (not obj)
+                    {
+                        for (auto o : objv) discard(o);
+                        return Error::index(obj.error(), i);
+                    }
+                    objv.push_back(*obj);
+                }
+
+                return Tcl_NewListObj(int(objv.size()), objv.data());
+            }
+        }
+
+        // rows * cols values, and their bytes, must be countable
+        template <typename T>
+        bool fits(std::size_t rows, std::size_t cols)
+        {
+            return (cols == 0) or (rows <= std::numeric_limits<std::size_t>::max() / sizeof (T) / cols);
+        }
+
+        inline std::unexpected<Error> size_error(std::size_t rows, std::size_t cols)
+        {
+            return Error::generic
+            (
+                [rows, cols] (std::ostream & os)
+                {
+                    os << "matrix too large ("sv << rows << " x "sv << cols << ')';
+                }
+            );
+        }
+    }
+
+    template <typename T>
+    class Type<Packed<T>>
+    {
+        static auto make_name()
+        {
+            return std::format("<packed {}>"sv, Type<T>::name());
+        }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        static FromResult<Packed<T>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            Tcl_Obj **objv;
+            int objc;
+
+            if (Tcl_ListObjGetElements(tcl, obj, &objc, &objv) != TCL_OK)
+            {
+#if XTCL_ERROR_TCL
+                return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+#else
+                return detail::type_error<Packed<T>>(obj);
+#endif
+            }
+
+            if (objc != 3)
+            {
+                return detail::type_error<Packed<T>>(obj);
+            }
+
+            auto rows = Xtcl::from<std::size_t>(tcl, objv[0]);
+            if (not rows)
+            {
+                return Error::index(rows.error(), 0);
+            }
+
+            auto cols = Xtcl::from<std::size_t>(tcl, objv[1]);
+            if (not cols)
+            {
+                return Error::index(cols.error(), 1);
+            }
+
+            if (not detail::fits<T>(*rows, *cols))
+            {
+                return detail::size_error(*rows, *cols);
+            }
+
+            int length;
+            unsigned char const * bytes = Tcl_GetByteArrayFromObj(objv[2], &length);
+
+            std::size_t const size {*rows * *cols};
+
+            if (std::size_t(length) != size * sizeof (T))
+            {
+                return Error::generic
+                (
+                    [size, length] (std::ostream & os)
+                    {
+                        os << "[2] expected "sv << size * sizeof (T) << " bytes but got "sv << length;
+                    }
+                );
+            }
+
+            std::vector<T> values(size);
+            std::memcpy(values.data(), bytes, size * sizeof (T));
+
+            return Packed<T> {*rows, *cols, std::move(values)};
+        }
+
+        static ToResult to(Tcl_Interp *, Packed<T> const & matrix)
+        {
+            std::size_t const length {matrix.size() * sizeof (T)};
+
+            if (length > std::size_t(std::numeric_limits<int>::max()))
+            {
+                return detail::size_error(matrix.rows(), matrix.cols());
+            }
+
+            Tcl_Obj * objv[]
+            {
+                Tcl_NewWideIntObj(Tcl_WideInt(matrix.rows())),
+                Tcl_NewWideIntObj(Tcl_WideInt(matrix.cols())),
+                Tcl_NewByteArrayObj(reinterpret_cast<unsigned char const *>(matrix.data()), int(length))
+            };
+
+            return Tcl_NewListObj(3, objv);
+        }
+    };
+
+    template <typename T>
+    class Type<Matrix<T>>
+    {
+        static auto make_name()
+        {
+            return std::format("<matrix {}>"sv, Type<T>::name());
+        }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        static FromResult<Matrix<T>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            Tcl_Obj **rowv;
+            int rowc;
+
+            if (Tcl_ListObjGetElements(tcl, obj, &rowc, &rowv) != TCL_OK)
+            {
+#if XTCL_ERROR_TCL
+                return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+#else
+                return detail::type_error<Matrix<T>>(obj);
+#endif
+            }
+
+            std::vector<T> values {};
+            std::size_t cols {};
+
+            for (std::size_t r = 0; r < rowc; ++r)
+            {
+                Tcl_Obj **objv;
+                int objc;
+
+                if (Tcl_ListObjGetElements(tcl, rowv[r], &objc, &objv) != TCL_OK)
+                {
+#if XTCL_ERROR_TCL
+                    auto e = Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+#else
+                    auto e = detail::type_error<std::vector<T>>(rowv[r]);
+#endif
+                    return Error::index(e.error(), r);
+                }
+
+                if (r == 0)
+                {
+                    cols = objc;
+                    if (not detail::fits<T>(rowc, cols))
+                    {
+                        return detail::size_error(rowc, cols);
+                    }
+                    values.reserve(rowc * cols);
+                }
+                else if (objc != cols)
+                {
+                    return Error::generic
+                    (
+                        [r, cols, objc] (std::ostream & os)
+                        {
+                            os << '[' << r << "] expected "sv << cols << " elements but got "sv << objc;
+                        }
+                    );
+                }
+
+                for (std::size_t c = 0; c < cols; ++c)
+                {
+                    auto e = Xtcl::from<T>(tcl, objv[c]);
+                    if (not e)
+                    {
+                        Error error {Error::index(e.error(), c).error()};
+                        return Error::index(error, r);
+                    }
+                    values.push_back(std::move(*e));
+                }
+            }
+
+            return Matrix<T> {std::size_t(rowc), cols, std::move(values)};
+        }
+
+        static ToResult to(Tcl_Interp * tcl, Matrix<T> const & matrix)
+        {
+            return detail::to_nested(tcl, matrix);
+        }
+    };
+
+#if XTCL_SUPPORT_MDSPAN
+    template <typename T, typename E, typename L, typename A>
+    class Type<std::mdspan<T, E, L, A>>
+    {
+        using M = std::mdspan<T, E, L, A>;
+
+        static auto make_name()
+        {
+            return std::format("<mdspan {} x {}>"sv, Type<std::remove_const_t<T>>::name(), M::rank());
+        }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        static ToResult to(Tcl_Interp * tcl, M const & m)
+        {
+            return detail::to_nested(tcl, m);
+        }
+    };
+#endif
+}
+
+#if XTCL_EXTERN_TEMPLATES
+// instantiated once in src/xtcl_instances.cpp
+#define XTCL_TYPE_INSTANCE(...) extern template struct Xtcl::Type<__VA_ARGS__>
+#include "xtcl_instances.h"
+#undef XTCL_TYPE_INSTANCE
+#endif
+
 #endif
@@ -0,0 +1,469 @@
+#ifndef XTCL_VAR_H
+#define XTCL_VAR_H
+
+#include <tcl/tcl.h>
+
+#include <utility>
+#include <optional>
+#include <string_view>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+#include "xtcl_def.h"
+#include "xtcl_type.h"
+#include "xtcl_error.h"
+
+using namespace std::literals;
+
+namespace Xtcl
+{
+    namespace detail
+    {
+        // variable whose value is written back when the function returns, its object being held so that it stays valid
+        // whatever the function does to the variable in the meantime
+        class VarBase
+        {
+        protected :
+
+            Tcl_Interp * tcl;
+            Tcl_Obj * name;
+            Tcl_Obj * obj;
+            bool copied;
+            bool changed;
+
+            VarBase(Tcl_Interp * tcl, Tcl_Obj * name, Tcl_Obj * obj) : tcl {tcl}, name {name}, obj {obj}, copied {}, changed {}
+            {
+                Tcl_IncrRefCount(obj);
+            }
+
+            VarBase(VarBase && var) : tcl {var.tcl}, name {var.name}, obj {std::exchange(var.obj, nullptr)}, copied {var.copied}, changed {std::exchange(var.changed, false)} {}
+
+            ~VarBase()
+            {
+                if (obj != nullptr)
+                {
+                    Tcl_DecrRefCount(obj);
+                }
+            }
+
+            // the variable's object is modified in place when only the variable and this one hold it, duplicated
+            // (shallowly) otherwise
+            template <typename F>
+            void modify(F && f)
+            {
+                // the function may have set the variable to another value meanwhile
+                bool const held {(not copied) and (obj->refCount == 2) and (Tcl_ObjGetVar2(tcl, name, nullptr, 0) == obj)};
+
+                if (obj->refCount > (held ? 2 : 1))
+                {
+                    Tcl_Obj * dup = Tcl_DuplicateObj(obj);
+                    Tcl_IncrRefCount(dup);
+                    Tcl_DecrRefCount(obj);
+                    obj = dup;
+                    copied = true;
+                }
+
+                changed = true;
+
+                // the variable's reference stands for this one meanwhile, Tcl refusing to modify shared objects
+                bool const lent {held and (obj->refCount == 2)};
+                if (lent)
+                {
+                    Tcl_DecrRefCount(obj);
+                }
+
+                std::forward<F>(f)(obj);
+
+                if (lent)
+                {
+                    Tcl_IncrRefCount(obj);
+                }
+            }
+
+            Result<void> set(Tcl_Obj * value)
+            {
+                // held during the call, so that it is released if the variable cannot be set
+                Tcl_IncrRefCount(value);
+
+                // also fires the variable's write traces when its object was modified in place
+                Tcl_Obj * set = Tcl_ObjSetVar2(tcl, name, nullptr, value, TCL_LEAVE_ERR_MSG);
+
+                Tcl_DecrRefCount(value);
+
+                if (set == nullptr)
+                {
+                    return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+                }
+
+                return {};
+            }
+
+        public :
+
+            VarBase(VarBase const &) = delete;
+            VarBase & operator = (VarBase const &) = delete;
+
+            Result<void> commit()
+            {
+                return changed ? set(obj) : Result<void> {};
+            }
+        };
+
+        inline Result<Tcl_Obj *> get_var(Tcl_Interp * tcl, Tcl_Obj * name)
+        {
+            Tcl_Obj * obj = Tcl_ObjGetVar2(tcl, name, nullptr, TCL_LEAVE_ERR_MSG);
+            if (obj == nullptr)
+            {
+                return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+            }
+
+            return obj;
+        }
+    }
+
+    // in-out argument: the name of a variable, whose value is decoded and encoded back when the function returns
+    template <typename T>
+    class Var : public detail::VarBase
+    {
+        T val;
+
+    public :
+
+        Var(Tcl_Interp * tcl, Tcl_Obj * name, Tcl_Obj * obj, T && value) : VarBase {tcl, name, obj}, val {std::move(value)} {}
+
+        Var(Var && var) = default;
+
+        T & operator * () {return val;}
+        T const & operator * () const {return val;}
+
+        T * operator -> () {return &val;}
+        T const * operator -> () const {return &val;}
+
+        Result<void> commit()
+        {
+            auto value = Xtcl::to(tcl, std::move(val));
+            if (not value)
+            {
+                return Error::forward(value.error());
+            }
+
+            return set(*value);
+        }
+    };
+
+    // list variable, whose elements are decoded on access and encoded when changed
+    template <typename T>
+    class Var<std::vector<T>> : public detail::VarBase
+    {
+        // checked as a list when decoded
+        int length() const
+        {
+            int n;
+            Tcl_ListObjLength(nullptr, obj, &n);
+            return n;
+        }
+
+    public :
+
+        Var(Tcl_Interp * tcl, Tcl_Obj * name, Tcl_Obj * obj) : VarBase {tcl, name, obj} {}
+
+        Var(Var && var) = default;
+
+        std::size_t size() const
+        {
+            return std::size_t(length());
+        }
+
+        FromResult<T> get(std::size_t i) const
+        {
+            Tcl_Obj * e;
+            Tcl_ListObjIndex(nullptr, obj, int(i), &e);
+            if (e == nullptr)
+            {
+                return Error::generic([i] (std::ostream & os) {os << "index "sv << i << " out of range"sv;});
+            }
+
+            auto value = Xtcl::from<T>(tcl, e);
+            if (not value)
+            {
+                return Error::index(value.error(), i);
+            }
+
+            return value;
+        }
+
+        FromResult<std::vector<T>> value() const
+        {
+            return Xtcl::from<std::vector<T>>(tcl, obj);
+        }
+
+        Result<void> set(std::size_t i, T value)
+        {
+            if (i >= size())
+            {
+                return Error::generic([i] (std::ostream & os) {os << "index "sv << i << " out of range"sv;});
+            }
+
+            auto e = Xtcl::to(tcl, std::move(value));
+            if (not e)
+            {
+                return Error::index(e.error(), i);
+            }
+
+            modify([i, e = *e] (Tcl_Obj * list) mutable {Tcl_ListObjReplace(nullptr, list, int(i), 1, 1, &e);});
+
+            return {};
+        }
+
+        Result<void> push_back(T value)
+        {
+            auto e = Xtcl::to(tcl, std::move(value));
+            if (not e)
+            {
+                return Error::index(e.error(), size());
+            }
+
+            modify([e = *e] (Tcl_Obj * list) {Tcl_ListObjAppendElement(nullptr, list, e);});
+
+            return {};
+        }
+    };
+
+    namespace detail
+    {
+        // dictionary variable, whose entries are decoded on access and encoded when changed
+        template <template <typename, typename> typename M, typename K, typename V>
+        class MapVar : public VarBase
+        {
+        public :
+
+            MapVar(Tcl_Interp * tcl, Tcl_Obj * name, Tcl_Obj * obj) : VarBase {tcl, name, obj} {}
+
+            MapVar(MapVar && var) = default;
+
+            std::size_t size() const
+            {
+                int n;
+                Tcl_DictObjSize(nullptr, obj, &n);
+                return std::size_t(n);
+            }
+
+            FromResult<std::optional<V>> get(K const & key) const
+            {
+                auto k = Xtcl::to(tcl, key);
+                if (not k)
+                {
+                    return Error::forward(k.error());
+                }
+
+                Tcl_Obj * e;
+                Tcl_IncrRefCount(*k);
+                Tcl_DictObjGet(nullptr, obj, *k, &e);
+                Tcl_DecrRefCount(*k);
+
+                if (e == nullptr)
+                {
+                    return std::nullopt;
+                }
+
+                return Xtcl::from<V>(tcl, e);
+            }
+
+            FromResult<M<K, V>> value() const
+            {
+                return Xtcl::from<M<K, V>>(tcl, obj);
+            }
+
+            Result<void> set(K const & key, V value)
+            {
+                auto k = Xtcl::to(tcl, key);
+                if (not k)
+                {
+                    return Error::forward(k.error());
+                }
+
+                auto v = Xtcl::to(tcl, std::move(value));
+                if (not v)
+                {
+                    discard(*k);
+                    return Error::forward(v.error());
+                }
+
+                modify([k = *k, v = *v] (Tcl_Obj * dict) {Tcl_DictObjPut(nullptr, dict, k, v);});
+
+                return {};
+            }
+
+            Result<void> erase(K const & key)
+            {
+                auto k = Xtcl::to(tcl, key);
+                if (not k)
+                {
+                    return Error::forward(k.error());
+                }
+
+                Tcl_IncrRefCount(*k);
+                modify([k = *k] (Tcl_Obj * dict) {Tcl_DictObjRemove(nullptr, dict, k);});
+                Tcl_DecrRefCount(*k);
+
+                return {};
+            }
+        };
+    }
+
+    template <typename K, typename V>
+    class Var<std::map<K, V>> : public detail::MapVar<std::map, K, V>
+    {
+        using detail::MapVar<std::map, K, V>::MapVar;
+    };
+
+    template <typename K, typename V>
+    class Var<std::unordered_map<K, V>> : public detail::MapVar<std::unordered_map, K, V>
+    {
+        using detail::MapVar<std::unordered_map, K, V>::MapVar;
+    };
+
+    template <typename T>
+    class Type<Var<T>>
+    {
+        static auto make_name()
+        {
+            return std::format("<var {}>"sv, Type<T>::name());
+        }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        static FromResult<Var<T>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            auto var = detail::get_var(tcl, obj);
+            if (not var)
+            {
+                return Error::forward(var.error());
+            }
+
+            auto value = Xtcl::from<T>(tcl, *var);
+            if (not value)
+            {
+                return Error::forward(value.error());
+            }
+
+            return Var<T> {tcl, obj, *var, std::move(*value)};
+        }
+    };
+
+    template <typename T>
+    class Type<Var<std::vector<T>>>
+    {
+        static auto make_name()
+        {
+            return std::format("<var {}>"sv, Type<std::vector<T>>::name());
+        }
+
+    public :
+
+        static auto name()
+        {
+            static std::string const name {make_name()};
+            return std::string_view {name};
+        }
+
+        static FromResult<Var<std::vector<T>>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+        {
+            auto var = detail::get_var(tcl, obj);
+            if (not var)
+            {
+                return Error::forward(var.error());
+            }
+
+            int n;
+            if (Tcl_ListObjLength(tcl, *var, &n) != TCL_OK)
+            {
+#if XTCL_ERROR_TCL
+                return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+#else
+                return detail::type_error<std::vector<T>>(*var);
+#endif
+            }
+
+            return Var<std::vector<T>> {tcl, obj, *var};
+        }
+    };
+
+    namespace detail
+    {
+        template <typename M>
+        struct MapVarType
+        {
+            static auto make_name()
+            {
+                return std::format("<var {}>"sv, Type<M>::name());
+            }
+
+            static auto name()
+            {
+                static std::string const name {make_name()};
+                return std::string_view {name};
+            }
+
+            static FromResult<Var<M>> from(Tcl_Interp * tcl, Tcl_Obj * obj)
+            {
+                auto var = get_var(tcl, obj);
+                if (not var)
+                {
+                    return Error::forward(var.error());
+                }
+
+                int n;
+                if (Tcl_DictObjSize(tcl, *var, &n) != TCL_OK)
+                {
+#if XTCL_ERROR_TCL
+                    return Error::text(Tcl_GetString(Tcl_GetObjResult(tcl)));
+#else
+                    return type_error<M>(*var);
+#endif
+                }
+
+                return Var<M> {tcl, obj, *var};
+            }
+        };
+    }
+
+    template <typename K, typename V>
+    struct Type<Var<std::map<K, V>>> : public detail::MapVarType<std::map<K, V>> {};
+
+    template <typename K, typename V>
+    struct Type<Var<std::unordered_map<K, V>>> : public detail::MapVarType<std::unordered_map<K, V>> {};
+
+    // arguments written back when the function returns
+    template <typename T>
+    concept Committed = requires (T & value)
+    {
+        {value.commit()} -> std::same_as<Result<void>>;
+    };
+
+    namespace detail
+    {
+        template <typename T>
+        Result<void> commit(T & arg)
+        {
+            if constexpr (Committed<T>)
+            {
+                return arg.commit();
+            }
+            else
+            {
+                return {};
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,66 @@
+// Module interface: import xtcl;
+// The XTCL_* definitions (see xtcl_def.h) must be set when building this unit, they cannot be exported.
+// XTCL_PACKAGE and XTCL_ENUM are macros, so code using them still includes xtcl_package.h or xtcl.h.
+
+module;
+
+#include <xtcl.h>
+#include <xtcl_package.h>
+#include <xtcl_channel.h>
+#include <xtcl_options.h>
+#include <xtcl_abstract.h>
+#include <xtcl_command.h>
+#include <xtcl_memo.h>
+#include <xtcl_ensemble.h>
+
+export module xtcl;
+
+export namespace Xtcl
+{
+    using Xtcl::Value;
+    using Xtcl::Result;
+    using Xtcl::FromResult;
+    using Xtcl::ToResult;
+    using Xtcl::Msg;
+    using Xtcl::Error;
+    using Xtcl::Type;
+    using Xtcl::Assignable;
+    using Xtcl::Literal;
+    using Xtcl::Fields;
+    using Xtcl::Enumerators;
+    using Xtcl::NamedEnum;
+    using Xtcl::from;
+    using Xtcl::to;
+    using Xtcl::add_function;
+    using Xtcl::add_pure_function;
+    using Xtcl::add_memo;
+    using Xtcl::add_ensemble;
+    using Xtcl::Injected;
+    using Xtcl::Trailing;
+    using Xtcl::Native;
+    using Xtcl::Stateful;
+    using Xtcl::Matrix;
+    using Xtcl::Packed;
+    using Xtcl::Rest;
+    using Xtcl::Cancel;
+    using Xtcl::canceled;
+    using Xtcl::Var;
+    using Xtcl::Committed;
+    using Xtcl::InChannel;
+    using Xtcl::OutChannel;
+    using Xtcl::Options;
+    using Xtcl::AbstractList;
+    using Xtcl::Command;
+    using Xtcl::Binding;
+    using Xtcl::Package;
+#if XTCL_TRACE == 1
+    using Xtcl::add_trace;
+#endif
+
+    inline namespace literals
+    {
+        using Xtcl::literals::operator ""_tcl;
+    }
+}
+
+export using ::operator <<;
@@ -0,0 +1,8 @@
+// Explicit instantiation of the Type specializations declared extern when XTCL_EXTERN_TEMPLATES is enabled.
+// Must be built with the same XTCL_* definitions as the rest of the program.
+
+#include <xtcl.h>
+
+#define XTCL_TYPE_INSTANCE(...) template struct Xtcl::Type<__VA_ARGS__>
+#include <xtcl_instances.h>
+#undef XTCL_TYPE_INSTANCE